@@ -45,6 +45,7 @@ if (NOT (RUNNING_ON_APPVEYOR AND SLEEF_CLANG_ON_WINDOWS))
   find_library(LIBGMP gmp)
   find_library(LIBRT rt)
   find_library(LIBFFTW3 fftw3)
+  find_library(LIBFFTW3F fftw3f)
 
   if (LIB_MPFR)
     find_path(MPFR_INCLUDE_DIR
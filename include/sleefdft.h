@@ -18,12 +18,31 @@ extern "C"
 #define SLEEF_MODE_ALT         (1 <<  2)
 #define SLEEF_MODE_FFTWCOMPAT  (1 <<  3)
 
+#define SLEEF_MODE_POWER       (1 <<  4)
+#define SLEEF_MODE_MAGNITUDE   (2 <<  4)
+#define SLEEF_MODE_POWERDB     (3 <<  4)
+#define SLEEF_MODE_PHASE       (4 <<  4)
+
 #define SLEEF_MODE_DEBUG       (1 << 10)
 #define SLEEF_MODE_VERBOSE     (1 << 11)
 #define SLEEF_MODE_NO_MT       (1 << 12)
+#define SLEEF_MODE_ASYNC       (1 << 13)
+#define SLEEF_MODE_COUNTERS    (1 << 14)
+#define SLEEF_MODE_UNALIGNED   (1 << 15)
+#define SLEEF_MODE_FP16        (1 << 16)
+#define SLEEF_MODE_BF16        (1 << 17)
+#define SLEEF_MODE_INT16       (1 << 18)
+#define SLEEF_MODE_INT32       (1 << 19)
 
 #define SLEEF_MODE_ESTIMATE    (1 << 20)
 #define SLEEF_MODE_MEASURE     (2 << 20)
+#define SLEEF_MODE_QUICK       ((2 << 20) | (1 << 22))
+#define SLEEF_MODE_PATIENT     ((2 << 20) | (2 << 22))
+#define SLEEF_MODE_EXHAUSTIVE  ((2 << 20) | (3 << 22))
+#define SLEEF_MODE_REALTIME    (1 << 24)
+#define SLEEF_MODE_REPRODUCIBLE (1 << 25)
+
+#define SLEEF_MODE_TIMEBUDGET(ms) (((uint64_t)(ms) & 0xffffffff) << 32)
 
 #if (defined(__MINGW32__) || defined(__MINGW64__) || defined(__CYGWIN__) || defined(_MSC_VER)) && !defined(SLEEF_STATIC_LIBS)
 #ifdef IMPORT_IS_EXPORT
@@ -41,24 +60,95 @@ extern "C"
 IMPORT struct SleefDFT *SleefDFT_double_init1d(uint32_t n, const double *in, double *out, uint64_t mode);
 IMPORT struct SleefDFT *SleefDFT_double_init2d(uint32_t n, uint32_t m, const double *in, double *out, uint64_t mode);
 IMPORT void SleefDFT_double_execute(struct SleefDFT *ptr, const double *in, double *out);
+IMPORT void SleefDFT_double_executeInt(struct SleefDFT *ptr, const void *in, void *out, double scale);
 
 IMPORT struct SleefDFT *SleefDFT_float_init1d(uint32_t n, const float *in, float *out, uint64_t mode);
 IMPORT struct SleefDFT *SleefDFT_float_init2d(uint32_t n, uint32_t m, const float *in, float *out, uint64_t mode);
 IMPORT void SleefDFT_float_execute(struct SleefDFT *ptr, const float *in, float *out);
+IMPORT void SleefDFT_float_execute16(struct SleefDFT *ptr, const uint16_t *in, uint16_t *out);
+IMPORT void SleefDFT_float_executeInt(struct SleefDFT *ptr, const void *in, void *out, float scale);
+
+IMPORT struct SleefDFT *SleefDFT_double_init1dPruned(uint32_t n, uint32_t nIn, uint32_t nOut, const double *in, double *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_float_init1dPruned(uint32_t n, uint32_t nIn, uint32_t nOut, const float *in, float *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_double_init1dBatch(uint32_t n, uint32_t batch, const double *in, double *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_float_init1dBatch(uint32_t n, uint32_t batch, const float *in, float *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_double_init2dBatch(uint32_t n, uint32_t m, uint32_t batch, uint64_t stride, const double *in, double *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_float_init2dBatch(uint32_t n, uint32_t m, uint32_t batch, uint64_t stride, const float *in, float *out, uint64_t mode);
+
+typedef void (*SleefDFT_callbackFunc)(void *arg);
+
+IMPORT struct SleefDFT *SleefDFT_double_initGraph(uint64_t mode);
+IMPORT int SleefDFT_double_addTransform(struct SleefDFT *graph, struct SleefDFT *plan, const double *in, double *out, int nDeps, const int *deps);
+IMPORT int SleefDFT_double_addCallback(struct SleefDFT *graph, SleefDFT_callbackFunc func, void *arg, int nDeps, const int *deps);
+IMPORT struct SleefDFT *SleefDFT_float_initGraph(uint64_t mode);
+IMPORT int SleefDFT_float_addTransform(struct SleefDFT *graph, struct SleefDFT *plan, const float *in, float *out, int nDeps, const int *deps);
+IMPORT int SleefDFT_float_addCallback(struct SleefDFT *graph, SleefDFT_callbackFunc func, void *arg, int nDeps, const int *deps);
+
+IMPORT struct SleefDFT *SleefDFT_longdouble_init1d(uint32_t n, const long double *in, long double *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_longdouble_init2d(uint32_t n, uint32_t m, const long double *in, long double *out, uint64_t mode);
+IMPORT void SleefDFT_longdouble_execute(struct SleefDFT *ptr, const long double *in, long double *out);
+
+#if defined(Sleef_quad_DEFINED)
+IMPORT struct SleefDFT *SleefDFT_quad_init1d(uint32_t n, const Sleef_quad *in, Sleef_quad *out, uint64_t mode);
+IMPORT struct SleefDFT *SleefDFT_quad_init2d(uint32_t n, uint32_t m, const Sleef_quad *in, Sleef_quad *out, uint64_t mode);
+IMPORT void SleefDFT_quad_execute(struct SleefDFT *ptr, const Sleef_quad *in, Sleef_quad *out);
+#endif
 
 IMPORT void SleefDFT_dispose(struct SleefDFT *ptr);
 
 IMPORT void SleefDFT_setPath(struct SleefDFT *ptr, char *pathStr);
 
+#define SLEEF_INFO_MAXPATHLEN 32
+
+typedef struct SleefDFT_info {
+  const char *isaName;
+  int vectorBits;
+  int log2len;
+  int pathLen;
+  int path[SLEEF_INFO_MAXPATHLEN], config[SLEEF_INFO_MAXPATHLEN];
+  uint64_t estimatedTime, measuredTime;
+  uint64_t tableBytes, scratchBytes;
+  int transposeMT;
+  struct SleefDFT *rowPlan, *columnPlan;
+} SleefDFT_info;
+
+IMPORT int SleefDFT_getInfo(struct SleefDFT *ptr, SleefDFT_info *info);
+IMPORT int SleefDFT_getPath(struct SleefDFT *ptr, char *pathStr, int size);
+IMPORT int SleefDFT_getCounters(struct SleefDFT *ptr, uint64_t *ticks, uint64_t *calls, int n);
+IMPORT void SleefDFT_resetCounters(struct SleefDFT *ptr);
+IMPORT void SleefDFT_prefetch(struct SleefDFT *ptr);
+
+//
+
+#define SLEEF_OOC_INPUT  0
+#define SLEEF_OOC_OUTPUT 1
+
+typedef int (*SleefDFT_readFunc)(void *ctx, int target, uint64_t offset, void *buf, uint64_t size);
+typedef int (*SleefDFT_writeFunc)(void *ctx, uint64_t offset, const void *buf, uint64_t size);
+
+IMPORT struct SleefDFT *SleefDFT_double_init1dOutOfCore(uint64_t n, uint64_t memLimit, uint64_t mode);
+IMPORT int SleefDFT_double_executeOutOfCore(struct SleefDFT *ptr, SleefDFT_readFunc readFunc, SleefDFT_writeFunc writeFunc, void *ctx);
+IMPORT int SleefDFT_double_executeFile(struct SleefDFT *ptr, const char *inPath, const char *outPath);
+
+IMPORT struct SleefDFT *SleefDFT_float_init1dOutOfCore(uint64_t n, uint64_t memLimit, uint64_t mode);
+IMPORT int SleefDFT_float_executeOutOfCore(struct SleefDFT *ptr, SleefDFT_readFunc readFunc, SleefDFT_writeFunc writeFunc, void *ctx);
+IMPORT int SleefDFT_float_executeFile(struct SleefDFT *ptr, const char *inPath, const char *outPath);
+
+IMPORT int64_t SleefDFT_double_executeStream(struct SleefDFT *ptr, uint64_t nBlocks, SleefDFT_readFunc readFunc, SleefDFT_writeFunc writeFunc, void *ctx);
+IMPORT int64_t SleefDFT_float_executeStream(struct SleefDFT *ptr, uint64_t nBlocks, SleefDFT_readFunc readFunc, SleefDFT_writeFunc writeFunc, void *ctx);
+
 //
 
 IMPORT void SleefDFT_setPlanFilePath(const char *path, const char *arch, uint64_t mode);
+IMPORT size_t SleefDFT_exportPlans(void *buf, size_t size);
+IMPORT int SleefDFT_importPlans(const void *buf, size_t size);
 
 #define SLEEF_PLAN_AUTOMATIC 0
 #define SLEEF_PLAN_READONLY (1 << 0)
 #define SLEEF_PLAN_RESET (1 << 1)
 #define SLEEF_PLAN_BUILDALLPLAN (1 << 2)
 #define SLEEF_PLAN_NOLOCK (1 << 3)
+#define SLEEF_PLAN_BINARY (1 << 4)
 #define SLEEF_PLAN_MEASURE (1 << 29)
 #define SLEEF_PLAN_REFERTOENVVAR (1 << 30)
 
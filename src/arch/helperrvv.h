@@ -13,9 +13,25 @@
 #if CONFIG == 1
 #define ISANAME "RISC-V Vector Extension with Min. VLEN"
 #define SLEEF_RVV_VLEN __riscv_v_min_vlen
+#elif CONFIG == 7
+// Fixed vector lengths, used by DFT
+#define ISANAME "RISC-V Vector Extension VLEN=128"
+#define SLEEF_RVV_VLEN 128
+#define DFTPRIORITY 20
+#elif CONFIG == 8
+#define ISANAME "RISC-V Vector Extension VLEN=256"
+#define SLEEF_RVV_VLEN 256
+#define DFTPRIORITY 21
+#elif CONFIG == 9
+#define ISANAME "RISC-V Vector Extension VLEN=512"
+#define SLEEF_RVV_VLEN 512
+#define DFTPRIORITY 22
+#elif CONFIG == 10
+#define ISANAME "RISC-V Vector Extension VLEN=1024"
+#define SLEEF_RVV_VLEN 1024
+#define DFTPRIORITY 23
 #else
-#define ISANAME "RISC-V Vector Extension VLEN=2^"#CONFIG
-#define SLEEF_RVV_VLEN (1 << CONFIG)
+#error CONFIG macro invalid or not defined
 #endif
 
 #ifndef CONFIG
@@ -26,7 +42,13 @@
 #define ENABLE_FMA_DP
 #define ENABLE_DP
 
+#if CONFIG == 1
 static INLINE int vavailability_i(int name) { return -1; }
+#else
+// Code for a fixed vector length sets vl explicitly, and thus also
+// runs on wider vectors
+static INLINE int vavailability_i(int name) { return vsetvlmax_e8m1() * 8 >= SLEEF_RVV_VLEN ? 3 : 0; }
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 // RISC-V Vector Types
@@ -241,6 +263,12 @@ typedef vint32m8_t dfi_t;
 
 #endif // ENABLE_RVVM1
 
+#if CONFIG != 1
+// For DFT, the vector length is a compile-time constant
+#define LOG2VECTLENDP (CONFIG - 7 + SLEEF_RVV_DP_LMUL)
+#define LOG2VECTLENSP (LOG2VECTLENDP+1)
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // Single-Precision Functions
 ////////////////////////////////////////////////////////////////////////////////
@@ -1013,4 +1041,70 @@ static INLINE vint vand_vi_vo_vi(vopmask x, vint y) {
 }
 #endif // ENABLE_RVV_DP
 
+////////////////////////////////////////////////////////////////////////////////
+// Operations for DFT
+////////////////////////////////////////////////////////////////////////////////
+
+// Complex numbers are stored as (real, imaginary) pairs of elements.
+// The sign of the odd or even elements is flipped with the element
+// index, and pairs are permuted with vrgather.
+
+#ifdef ENABLE_RVVM1
+#define SLEEF_RVV_DP_VID vid_v_u64m1
+#define SLEEF_RVV_SP_VID vid_v_u32m1
+#else
+#define SLEEF_RVV_DP_VID vid_v_u64m2
+#define SLEEF_RVV_SP_VID vid_v_u32m2
+#endif
+
+static INLINE vdouble vposneg_vd_vd(vdouble d) {
+  return SLEEF_RVV_DP_VREINTERPRET_VD(vxor(SLEEF_RVV_DP_VREINTERPRET_VU64(d), vsll(vand(SLEEF_RVV_DP_VID(VECTLENDP), 1, VECTLENDP), 63, VECTLENDP), VECTLENDP));
+}
+static INLINE vdouble vnegpos_vd_vd(vdouble d) {
+  return SLEEF_RVV_DP_VREINTERPRET_VD(vxor(SLEEF_RVV_DP_VREINTERPRET_VU64(d), vsll(vxor(vand(SLEEF_RVV_DP_VID(VECTLENDP), 1, VECTLENDP), 1, VECTLENDP), 63, VECTLENDP), VECTLENDP));
+}
+static INLINE vfloat vposneg_vf_vf(vfloat d) {
+  return SLEEF_RVV_SP_VREINTERPRET_VF(vxor(SLEEF_RVV_SP_VREINTERPRET_VU(d), vsll(vand(SLEEF_RVV_SP_VID(VECTLENSP), 1, VECTLENSP), 31, VECTLENSP), VECTLENSP));
+}
+static INLINE vfloat vnegpos_vf_vf(vfloat d) {
+  return SLEEF_RVV_SP_VREINTERPRET_VF(vxor(SLEEF_RVV_SP_VREINTERPRET_VU(d), vsll(vxor(vand(SLEEF_RVV_SP_VID(VECTLENSP), 1, VECTLENSP), 1, VECTLENSP), 31, VECTLENSP), VECTLENSP));
+}
+
+static INLINE vdouble vsubadd_vd_vd_vd(vdouble x, vdouble y) { return vadd_vd_vd_vd(x, vnegpos_vd_vd(y)); }
+static INLINE vfloat vsubadd_vf_vf_vf(vfloat x, vfloat y) { return vadd_vf_vf_vf(x, vnegpos_vf_vf(y)); }
+static INLINE vdouble vmlsubadd_vd_vd_vd_vd(vdouble x, vdouble y, vdouble z) { return vfma_vd_vd_vd_vd(x, y, vnegpos_vd_vd(z)); }
+static INLINE vfloat vmlsubadd_vf_vf_vf_vf(vfloat x, vfloat y, vfloat z) { return vmla_vf_vf_vf_vf(x, y, vnegpos_vf_vf(z)); }
+
+static INLINE vdouble vrev21_vd_vd(vdouble d) {
+  return vrgather(d, vxor(SLEEF_RVV_DP_VID(VECTLENDP), 1, VECTLENDP), VECTLENDP);
+}
+static INLINE vfloat vrev21_vf_vf(vfloat d) {
+  return vrgather(d, vxor(SLEEF_RVV_SP_VID(VECTLENSP), 1, VECTLENSP), VECTLENSP);
+}
+
+static INLINE vdouble vreva2_vd_vd(vdouble d) {
+  return vrgather(d, vadd(vrsub(vand(SLEEF_RVV_DP_VID(VECTLENDP), ~(uint64_t)1, VECTLENDP), VECTLENDP-2, VECTLENDP),
+			  vand(SLEEF_RVV_DP_VID(VECTLENDP), 1, VECTLENDP), VECTLENDP), VECTLENDP);
+}
+static INLINE vfloat vreva2_vf_vf(vfloat d) {
+  return vrgather(d, vadd(vrsub(vand(SLEEF_RVV_SP_VID(VECTLENSP), ~(uint32_t)1, VECTLENSP), VECTLENSP-2, VECTLENSP),
+			  vand(SLEEF_RVV_SP_VID(VECTLENSP), 1, VECTLENSP), VECTLENSP), VECTLENSP);
+}
+
+static INLINE void vscatter2_v_p_i_i_vd(double *ptr, int offset, int step, vdouble v) {
+  vsuxei64(ptr + offset*2, vmul(vadd(vmul(vsrl(SLEEF_RVV_DP_VID(VECTLENDP), 1, VECTLENDP), step*2, VECTLENDP),
+				     vand(SLEEF_RVV_DP_VID(VECTLENDP), 1, VECTLENDP), VECTLENDP), sizeof(double), VECTLENDP), v, VECTLENDP);
+}
+static INLINE void vscatter2_v_p_i_i_vf(float *ptr, int offset, int step, vfloat v) {
+  vsuxei32(ptr + offset*2, vmul(vadd(vmul(vsrl(SLEEF_RVV_SP_VID(VECTLENSP), 1, VECTLENSP), step*2, VECTLENSP),
+				     vand(SLEEF_RVV_SP_VID(VECTLENSP), 1, VECTLENSP), VECTLENSP), sizeof(float), VECTLENSP), v, VECTLENSP);
+}
+
+static INLINE void vstream_v_p_vd(double *ptr, vdouble v) { vstore_v_p_vd(ptr, v); }
+static INLINE void vstream_v_p_vf(float *ptr, vfloat v) { vstore_v_p_vf(ptr, v); }
+static INLINE void vsscatter2_v_p_i_i_vd(double *ptr, int offset, int step, vdouble v) { vscatter2_v_p_i_i_vd(ptr, offset, step, v); }
+static INLINE void vsscatter2_v_p_i_i_vf(float *ptr, int offset, int step, vfloat v) { vscatter2_v_p_i_i_vf(ptr, offset, step, v); }
+
+static INLINE void vprefetch_v_p(const void *ptr) {}
+
 #endif // HELPERRVV_H
@@ -0,0 +1,55 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __CYCLECOUNTER_H__
+#define __CYCLECOUNTER_H__
+
+#include <stdint.h>
+
+// High resolution time stamp for timing short code sequences. The
+// unit depends on the platform; only differences of the returned
+// values measured on the same thread are meaningful.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_X64) || defined(_M_IX86)
+static inline uint64_t Sleef_readCycleCounter() { _ReadWriteBarrier(); return __rdtsc(); }
+#else
+#include <windows.h>
+static inline uint64_t Sleef_readCycleCounter() {
+  LARGE_INTEGER c;
+  QueryPerformanceCounter(&c);
+  return (uint64_t)c.QuadPart;
+}
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+static inline uint64_t Sleef_readCycleCounter() {
+  uint32_t lo, hi;
+  __asm__ __volatile__ ("lfence\n\trdtsc" : "=a" (lo), "=d" (hi) : : "memory");
+  return ((uint64_t)hi << 32) | lo;
+}
+#elif defined(__aarch64__)
+static inline uint64_t Sleef_readCycleCounter() {
+  uint64_t c;
+  __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (c) : : "memory");
+  return c;
+}
+#elif defined(__riscv) && __riscv_xlen == 64
+// rdcycle is not accessible from user mode on recent Linux kernels
+static inline uint64_t Sleef_readCycleCounter() {
+  uint64_t c;
+  __asm__ __volatile__ ("rdtime %0" : "=r" (c) : : "memory");
+  return c;
+}
+#else
+#include <time.h>
+static inline uint64_t Sleef_readCycleCounter() {
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return (uint64_t)tp.tv_sec * INT64_C(1000000000) + (uint64_t)tp.tv_nsec;
+}
+#endif
+
+#endif // #ifndef __CYCLECOUNTER_H__
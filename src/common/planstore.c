@@ -0,0 +1,406 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Binary plan store
+//
+// A plan store file consists of a header, records sorted by (arch,
+// key), and records appended after the last compaction. Readers map
+// the file and look up records in place without locking. Writers
+// append whole records with a single write to a file opened in append
+// mode, and a later record overrides an earlier one with the same
+// key. When the unsorted tail grows long, the file is compacted into
+// a temporary file, which then atomically replaces the original.
+// Records appended by another process during compaction may be lost,
+// which only means that the corresponding plans are measured again.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#define GETPID() ((int)getpid())
+#else
+#include <process.h>
+#define GETPID() ((int)_getpid())
+#endif
+
+#include "planstore.h"
+
+#define MAGIC_PLANSTORE 0x5e3c9a17
+#define PLANSTORE_MAGIC "SLEEFPS"
+#define PLANSTORE_VERSION 1
+#define PLANSTORE_ENDIANCHECK UINT64_C(0x0102030405060708)
+#define PLANSTORE_COMPACTION_THRESHOLD 256
+
+typedef struct {
+  char magic[8];
+  uint32_t version, recordSize;
+  uint64_t nSorted;
+  uint64_t endianCheck;
+  uint64_t reserved[4];
+} PlanStoreHeader;
+
+typedef struct {
+  uint64_t arch, key, value, check;
+} PlanStoreRecord;
+
+struct PlanStore {
+  uint32_t magic;
+  void *map;
+  size_t mapSize;
+  const PlanStoreRecord *sorted, *tail;
+  uint64_t nSorted, nTail;
+};
+
+uint64_t PlanStore_hashString(const char *str) {
+  uint64_t h = UINT64_C(0xcbf29ce484222325);
+  for(;*str != '\0';str++) h = (h ^ (uint8_t)*str) * UINT64_C(0x100000001b3);
+  return h;
+}
+
+static uint64_t mix(uint64_t h) {
+  h = (h ^ (h >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  h = (h ^ (h >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return h ^ (h >> 31);
+}
+
+// A torn or garbage record fails this check
+static uint64_t checksum(uint64_t arch, uint64_t key, uint64_t value) {
+  return mix(mix(mix(arch) ^ key) ^ value) | 1;
+}
+
+static int recordValid(const PlanStoreRecord *r) { return r->check == checksum(r->arch, r->key, r->value); }
+
+static int headerValid(const PlanStoreHeader *h, uint64_t fileSize) {
+  return fileSize >= sizeof(PlanStoreHeader) &&
+    memcmp(h->magic, PLANSTORE_MAGIC, sizeof(PLANSTORE_MAGIC)) == 0 &&
+    h->version == PLANSTORE_VERSION && h->recordSize == sizeof(PlanStoreRecord) &&
+    h->endianCheck == PLANSTORE_ENDIANCHECK &&
+    h->nSorted <= (fileSize - sizeof(PlanStoreHeader)) / sizeof(PlanStoreRecord);
+}
+
+static void initHeader(PlanStoreHeader *h, uint64_t nSorted) {
+  memset(h, 0, sizeof(PlanStoreHeader));
+  memcpy(h->magic, PLANSTORE_MAGIC, sizeof(PLANSTORE_MAGIC));
+  h->version = PLANSTORE_VERSION;
+  h->recordSize = sizeof(PlanStoreRecord);
+  h->nSorted = nSorted;
+  h->endianCheck = PLANSTORE_ENDIANCHECK;
+}
+
+// Reads the whole file into memory
+static void *readFile(const char *fn, uint64_t *size) {
+  FILE *fp = fopen(fn, "rb");
+  if (fp == NULL) return NULL;
+  fseek(fp, 0, SEEK_END);
+  long z = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  void *buf = malloc(z > 0 ? z : 1);
+  if (z < 0 || fread(buf, 1, z, fp) != (size_t)z) {
+    free(buf);
+    fclose(fp);
+    return NULL;
+  }
+  fclose(fp);
+  *size = z;
+  return buf;
+}
+
+int PlanStore_isPlanStore(const char *fn) {
+  PlanStoreHeader h;
+  FILE *fp = fopen(fn, "rb");
+  if (fp == NULL) return 0;
+  int ret = fread(&h, sizeof(h), 1, fp) == 1 && memcmp(h.magic, PLANSTORE_MAGIC, sizeof(PLANSTORE_MAGIC)) == 0;
+  fclose(fp);
+  return ret;
+}
+
+PlanStore *PlanStore_open(const char *fn) {
+  PlanStore *thiz = (PlanStore *)calloc(1, sizeof(PlanStore));
+  thiz->magic = MAGIC_PLANSTORE;
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+  struct stat st;
+  int fd = open(fn, O_RDONLY);
+  if (fd == -1) { free(thiz); return NULL; }
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PlanStoreHeader)) {
+    close(fd);
+    free(thiz);
+    return NULL;
+  }
+  thiz->mapSize = st.st_size;
+  thiz->map = mmap(NULL, thiz->mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (thiz->map == MAP_FAILED) { free(thiz); return NULL; }
+#else
+  uint64_t size;
+  thiz->map = readFile(fn, &size);
+  if (thiz->map == NULL) { free(thiz); return NULL; }
+  thiz->mapSize = size;
+#endif
+
+  const PlanStoreHeader *h = (const PlanStoreHeader *)thiz->map;
+  if (!headerValid(h, thiz->mapSize)) {
+    PlanStore_close(thiz);
+    return NULL;
+  }
+
+  thiz->sorted = (const PlanStoreRecord *)((const char *)thiz->map + sizeof(PlanStoreHeader));
+  thiz->nSorted = h->nSorted;
+  thiz->tail = thiz->sorted + thiz->nSorted;
+  thiz->nTail = (thiz->mapSize - sizeof(PlanStoreHeader)) / sizeof(PlanStoreRecord) - thiz->nSorted;
+
+  return thiz;
+}
+
+void PlanStore_close(PlanStore *thiz) {
+  assert(thiz != NULL && thiz->magic == MAGIC_PLANSTORE);
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+  munmap(thiz->map, thiz->mapSize);
+#else
+  free(thiz->map);
+#endif
+  thiz->magic = 0;
+  free(thiz);
+}
+
+static int compareRecord(uint64_t arch0, uint64_t key0, const PlanStoreRecord *r) {
+  if (arch0 != r->arch) return arch0 < r->arch ? -1 : 1;
+  if (key0 != r->key) return key0 < r->key ? -1 : 1;
+  return 0;
+}
+
+int PlanStore_get(PlanStore *thiz, uint64_t arch, uint64_t key, uint64_t *value) {
+  assert(thiz != NULL && thiz->magic == MAGIC_PLANSTORE);
+
+  // The latest record in the tail takes precedence
+
+  for(int64_t i=(int64_t)thiz->nTail-1;i>=0;i--) {
+    const PlanStoreRecord *r = &thiz->tail[i];
+    if (r->arch == arch && r->key == key && recordValid(r)) {
+      *value = r->value;
+      return 1;
+    }
+  }
+
+  uint64_t lo = 0, hi = thiz->nSorted;
+  while(lo < hi) {
+    uint64_t mid = (lo + hi) / 2;
+    int c = compareRecord(arch, key, &thiz->sorted[mid]);
+    if (c == 0) {
+      if (!recordValid(&thiz->sorted[mid])) return 0;
+      *value = thiz->sorted[mid].value;
+      return 1;
+    }
+    if (c < 0) hi = mid; else lo = mid + 1;
+  }
+
+  return 0;
+}
+
+int PlanStore_list(PlanStore *thiz, uint64_t arch, uint64_t *keys, uint64_t *values, int max) {
+  assert(thiz != NULL && thiz->magic == MAGIC_PLANSTORE);
+
+  int n = 0;
+  for(uint64_t i=0;i<thiz->nSorted + thiz->nTail;i++) {
+    const PlanStoreRecord *r = &thiz->sorted[i];
+    if (r->arch != arch || !recordValid(r)) continue;
+    if (n < max) {
+      keys[n] = r->key;
+      values[n] = r->value;
+    }
+    n++;
+  }
+
+  return n;
+}
+
+// Creates a store without records if the file does not exist. The
+// header is written to a temporary file, which is then linked or
+// renamed to the file unless it exists, so that other processes never
+// see the file without a complete header.
+static void createIfMissing(const char *fn) {
+  FILE *fp = fopen(fn, "rb");
+  if (fp != NULL) {
+    fclose(fp);
+    return;
+  }
+
+  char *tmpfn = (char *)malloc(strlen(fn) + 32);
+  sprintf(tmpfn, "%s.%d.new", fn, GETPID());
+
+  fp = fopen(tmpfn, "wb");
+  if (fp == NULL) {
+    free(tmpfn);
+    return;
+  }
+
+  PlanStoreHeader h;
+  initHeader(&h, 0);
+  int ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+  if (fclose(fp) != 0) ok = 0;
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+  if (ok && link(tmpfn, fn) != 0 && errno != EEXIST) {
+    // The file system does not support hard links
+    int fd = open(fn, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd != -1) {
+      if (write(fd, &h, sizeof(h)) != sizeof(h)) remove(fn);
+      close(fd);
+    }
+  }
+  remove(tmpfn);
+#else
+  // rename() does not replace an existing file on Windows
+  if (!ok || rename(tmpfn, fn) != 0) remove(tmpfn);
+#endif
+
+  free(tmpfn);
+}
+
+int PlanStore_append(const char *fn, uint64_t arch, const uint64_t *keys, const uint64_t *values, int n) {
+  PlanStoreHeader h;
+
+  // The records are preceded by zeros that complete a record torn by
+  // an earlier write, so that the following records stay aligned
+  PlanStoreRecord *buf = (PlanStoreRecord *)calloc(n + 1, sizeof(PlanStoreRecord));
+  for(int i=0;i<n;i++) {
+    buf[i+1].arch = arch;
+    buf[i+1].key = keys[i];
+    buf[i+1].value = values[i];
+    buf[i+1].check = checksum(arch, keys[i], values[i]);
+  }
+
+  uint64_t fileSize, pad;
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+  createIfMissing(fn);
+
+  struct stat st;
+  int fd = open(fn, O_RDWR | O_APPEND);
+  if (fd == -1) { free(buf); return -1; }
+  if (fstat(fd, &st) != 0 || pread(fd, &h, sizeof(h), 0) != sizeof(h) || !headerValid(&h, st.st_size)) {
+    close(fd);
+    free(buf);
+    return -1;
+  }
+
+  pad = (sizeof(PlanStoreRecord) - (st.st_size - sizeof(PlanStoreHeader)) % sizeof(PlanStoreRecord)) % sizeof(PlanStoreRecord);
+  ssize_t z = (ssize_t)(sizeof(PlanStoreRecord) * n + pad);
+  int ok = write(fd, (char *)(buf + 1) - pad, z) == z;
+  if (ok && fstat(fd, &st) != 0) ok = 0;
+  fileSize = st.st_size;
+  close(fd);
+  free(buf);
+  if (!ok) return -1;
+#else
+  createIfMissing(fn);
+
+  FILE *fp = fopen(fn, "ab+");
+  if (fp == NULL) { free(buf); return -1; }
+  fseek(fp, 0, SEEK_END);
+  fileSize = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  if (fread(&h, sizeof(h), 1, fp) != 1 || !headerValid(&h, fileSize)) {
+    fclose(fp);
+    free(buf);
+    return -1;
+  }
+  pad = (sizeof(PlanStoreRecord) - (fileSize - sizeof(PlanStoreHeader)) % sizeof(PlanStoreRecord)) % sizeof(PlanStoreRecord);
+  size_t z = sizeof(PlanStoreRecord) * n + pad;
+  int ok = fwrite((char *)(buf + 1) - pad, 1, z, fp) == z;
+  fileSize += z;
+  fclose(fp);
+  free(buf);
+  if (!ok) return -1;
+#endif
+
+  uint64_t nTail = (fileSize - sizeof(PlanStoreHeader)) / sizeof(PlanStoreRecord) - h.nSorted;
+  if (nTail > PLANSTORE_COMPACTION_THRESHOLD && nTail > h.nSorted) PlanStore_compact(fn, 0, 0);
+
+  return 0;
+}
+
+typedef struct {
+  PlanStoreRecord r;
+  uint64_t seq;
+} seqRecord_t;
+
+static int compareSeqRecord(const void *a, const void *b) {
+  const seqRecord_t *x = (const seqRecord_t *)a, *y = (const seqRecord_t *)b;
+  int c = compareRecord(x->r.arch, x->r.key, &y->r);
+  if (c != 0) return c;
+  return x->seq < y->seq ? -1 : (x->seq > y->seq ? 1 : 0);
+}
+
+int PlanStore_compact(const char *fn, int excludeArch, uint64_t arch) {
+  uint64_t size;
+  char *file = (char *)readFile(fn, &size);
+  if (file == NULL) return -1;
+
+  PlanStoreHeader h = *(PlanStoreHeader *)file;
+  if (!headerValid(&h, size)) {
+    free(file);
+    return -1;
+  }
+
+  const PlanStoreRecord *rec = (const PlanStoreRecord *)(file + sizeof(PlanStoreHeader));
+  uint64_t nRec = (size - sizeof(PlanStoreHeader)) / sizeof(PlanStoreRecord), n = 0;
+
+  seqRecord_t *a = (seqRecord_t *)malloc(sizeof(seqRecord_t) * (nRec > 0 ? nRec : 1));
+  for(uint64_t i=0;i<nRec;i++) {
+    if (!recordValid(&rec[i]) || (excludeArch && rec[i].arch == arch)) continue;
+    a[n].r = rec[i];
+    a[n].seq = i;
+    n++;
+  }
+  free(file);
+
+  qsort(a, n, sizeof(seqRecord_t), compareSeqRecord);
+
+  // Keep the latest record for each key
+
+  uint64_t m = 0;
+  for(uint64_t i=0;i<n;i++) {
+    if (i+1 < n && a[i+1].r.arch == a[i].r.arch && a[i+1].r.key == a[i].r.key) continue;
+    a[m++] = a[i];
+  }
+
+  char *tmpfn = (char *)malloc(strlen(fn) + 32);
+  sprintf(tmpfn, "%s.%d.tmp", fn, GETPID());
+
+  FILE *fp = fopen(tmpfn, "wb");
+  if (fp == NULL) {
+    free(tmpfn);
+    free(a);
+    return -1;
+  }
+
+  initHeader(&h, m);
+  int ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+  for(uint64_t i=0;i<m && ok;i++) ok = fwrite(&a[i].r, sizeof(PlanStoreRecord), 1, fp) == 1;
+  if (fclose(fp) != 0) ok = 0;
+  free(a);
+
+#if defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER)
+  if (ok) remove(fn);
+#endif
+  if (!ok || rename(tmpfn, fn) != 0) {
+    remove(tmpfn);
+    free(tmpfn);
+    return -1;
+  }
+
+  free(tmpfn);
+  return 0;
+}
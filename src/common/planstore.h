@@ -0,0 +1,20 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef __PLANSTORE_H__
+#define __PLANSTORE_H__
+typedef struct PlanStore PlanStore;
+
+uint64_t PlanStore_hashString(const char *str);
+int PlanStore_isPlanStore(const char *fn);
+
+PlanStore *PlanStore_open(const char *fn);
+void PlanStore_close(PlanStore *thiz);
+int PlanStore_get(PlanStore *thiz, uint64_t arch, uint64_t key, uint64_t *value);
+int PlanStore_list(PlanStore *thiz, uint64_t arch, uint64_t *keys, uint64_t *values, int max);
+
+int PlanStore_append(const char *fn, uint64_t arch, const uint64_t *keys, const uint64_t *values, int n);
+int PlanStore_compact(const char *fn, int excludeArch, uint64_t arch);
+#endif
@@ -0,0 +1,111 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init2d SleefDFT_double_init2d
+#define SleefDFT_init2dBatch SleefDFT_double_init2dBatch
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init2d SleefDFT_float_init2d
+#define SleefDFT_init2dBatch SleefDFT_float_init2dBatch
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// A stack of images is transformed with a batched plan, and compared
+// with transforming each image with a 2D plan. The values between
+// strided images must not be modified.
+
+static int check(int n, int m, int batch, uint64_t stride, uint64_t mode) {
+  const uint64_t size = 2 * (uint64_t)n * m, step = stride == 0 ? size : stride;
+
+  struct SleefDFT *p = SleefDFT_init2dBatch(n, m, batch, stride, NULL, NULL, MODE | mode);
+  struct SleefDFT *q = SleefDFT_init2d(n, m, NULL, NULL, MODE | (mode & ~SLEEF_MODE_MEASURE) | SLEEF_MODE_ESTIMATE);
+
+  real *sx = (real *)Sleef_malloc(sizeof(real) * step * batch);
+  real *sy = (real *)Sleef_malloc(sizeof(real) * step * batch);
+  real *ty = (real *)Sleef_malloc(sizeof(real) * size);
+
+  for(uint64_t i=0;i<step * batch;i++) {
+    sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+    sy[i] = -1;
+  }
+
+  SleefDFT_execute(p, sx, sy);
+
+  int success = 1;
+
+  for(int b=0;b<batch;b++) {
+    SleefDFT_execute(q, sx + b * step, ty);
+
+    double rmsn = 0, rmsd = 0;
+    for(uint64_t i=0;i<size;i++) {
+      rmsn += (sy[b * step + i] - ty[i]) * (double)(sy[b * step + i] - ty[i]);
+      rmsd += ty[i] * (double)ty[i];
+    }
+    if (!(sqrt(rmsn / rmsd) < THRES)) success = 0;
+    for(uint64_t i=size;i<step;i++) if (sy[b * step + i] != -1) success = 0;
+  }
+
+  printf("%dx%d batch=%d stride=%llu mode=%llx : %s\n", n, m, batch, (unsigned long long)stride,
+	 (unsigned long long)mode, success ? "OK" : "NG");
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(q);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  success &= check(n, n, 37, 0, SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE);
+  success &= check(n, n, 37, 0, SLEEF_MODE_BACKWARD | SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT);
+  success &= check(n, n*2, 5, 2*n*n*2 + 6, SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE);
+  success &= check(n*2, n, 9, 2*n*n*2 + 10, SLEEF_MODE_BACKWARD | SLEEF_MODE_MEASURE);
+  success &= check(n, n, 1, 0, SLEEF_MODE_FORWARD | SLEEF_MODE_MEASURE);
+
+  // The stride must not be shorter than an image
+  if (SleefDFT_init2dBatch(n, n, 2, 2*n*n - 2, NULL, NULL, SLEEF_MODE_FORWARD) != NULL) {
+    printf("Overlapping images : NG\n");
+    success = 0;
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,114 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_init1dBatch SleefDFT_double_init1dBatch
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_init1dBatch SleefDFT_float_init1dBatch
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// Compares a batched transform with the real transform of each channel
+
+static int check(int n, int batch, uint64_t mode) {
+  const int backward = (mode & SLEEF_MODE_BACKWARD) != 0, ns = (mode & SLEEF_MODE_ALT) == 0 ? n + 2 : n;
+  const int nIn = backward ? ns : n, nOut = backward ? n : ns;
+
+  real *sx = (real *)Sleef_malloc(nIn * batch * sizeof(real));
+  real *sy = (real *)Sleef_malloc(nOut * batch * sizeof(real));
+  real *ty = (real *)Sleef_malloc(nOut * batch * sizeof(real));
+
+  for(int i=0;i<nIn*batch;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, mode | SLEEF_MODE_REAL | SLEEF_MODE_ESTIMATE);
+  struct SleefDFT *q = SleefDFT_init1dBatch(n, batch, NULL, NULL, MODE | mode | SLEEF_MODE_REAL);
+
+  for(int c=0;c<batch;c++) SleefDFT_execute(p, sx + c * nIn, ty + c * nOut);
+
+  // With SLEEF_MODE_DEBUG, pairing is chosen randomly on each execution
+
+  int success = 1;
+
+  for(int r=0;r<8;r++) {
+    SleefDFT_execute(q, sx, sy);
+
+    double rmsn = 0, rmsd = 0;
+    for(int i=0;i<nOut*batch;i++) {
+      rmsn += (sy[i] - ty[i]) * (double)(sy[i] - ty[i]);
+      rmsd += ty[i] * (double)ty[i];
+    }
+
+    if (!(sqrt(rmsn / rmsd) < THRES)) success = 0;
+  }
+
+  printf("n=%d batch=%d mode=%llx : %s\n", n, batch, (unsigned long long)mode, success ? "OK" : "NG");
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(q);
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  static const uint64_t modes[] = {
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_ESTIMATE,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_ESTIMATE,
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_MEASURE,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_MEASURE,
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_ALT | SLEEF_MODE_ESTIMATE,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_ALT | SLEEF_MODE_ESTIMATE,
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_DEBUG | SLEEF_MODE_ESTIMATE,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_DEBUG | SLEEF_MODE_ESTIMATE,
+  };
+
+  for(int i=0;i<8;i++) {
+    success &= check(n, 8, modes[i]);
+    success &= check(n, 7, modes[i]);
+    success &= check(n, 1, modes[i]);
+    success &= check(4, 5, modes[i]);
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,495 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Benchmark driver that sweeps transform sizes, precisions, real and
+// complex transforms, 1D and 2D transforms, thread counts and plan
+// modes, and reports the results in CSV or JSON. When built with
+// USEFFTW, FFTW is measured with the same parameters.
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef USEFFTW
+#include <fftw3.h>
+#endif
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+static uint64_t gettime() {
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return (uint64_t)tp.tv_sec * 1000000000 + ((uint64_t)tp.tv_nsec);
+}
+
+//
+
+typedef struct {
+  const char *name;
+  size_t size;
+  struct SleefDFT *(*init1d)(uint32_t n, uint64_t mode);
+  struct SleefDFT *(*init2d)(uint32_t n, uint32_t m, uint64_t mode);
+  void (*execute)(struct SleefDFT *p, const void *in, void *out);
+} prec_t;
+
+static struct SleefDFT *init1dDP(uint32_t n, uint64_t mode) { return SleefDFT_double_init1d(n, NULL, NULL, mode); }
+static struct SleefDFT *init2dDP(uint32_t n, uint32_t m, uint64_t mode) { return SleefDFT_double_init2d(n, m, NULL, NULL, mode); }
+static void executeDP(struct SleefDFT *p, const void *in, void *out) { SleefDFT_double_execute(p, (const double *)in, (double *)out); }
+
+static struct SleefDFT *init1dSP(uint32_t n, uint64_t mode) { return SleefDFT_float_init1d(n, NULL, NULL, mode); }
+static struct SleefDFT *init2dSP(uint32_t n, uint32_t m, uint64_t mode) { return SleefDFT_float_init2d(n, m, NULL, NULL, mode); }
+static void executeSP(struct SleefDFT *p, const void *in, void *out) { SleefDFT_float_execute(p, (const float *)in, (float *)out); }
+
+static const prec_t precs[] = {
+  { "dp", sizeof(double), init1dDP, init2dDP, executeDP },
+  { "sp", sizeof(float),  init1dSP, init2dSP, executeSP },
+};
+
+typedef struct {
+  const char *name;
+  uint64_t mode;
+} plan_t;
+
+static const plan_t plans[] = {
+  { "estimate", SLEEF_MODE_ESTIMATE },
+  { "measure", SLEEF_MODE_MEASURE },
+  { "quick", SLEEF_MODE_QUICK },
+  { "patient", SLEEF_MODE_PATIENT },
+  { "exhaustive", SLEEF_MODE_EXHAUSTIVE },
+};
+
+#define NPLANS ((int)(sizeof(plans) / sizeof(plans[0])))
+
+// Parameters of one benchmark run
+
+typedef struct {
+  const prec_t *prec;
+  const plan_t *plan;
+  int real, backward, dim, log2n, log2m, nThread;
+} config_t;
+
+// Results of one benchmark run
+
+typedef struct {
+  const char *impl, *isa;
+  double planNs, medianNs, minNs, gflops;
+  int64_t planBytes, bufferBytes;
+} result_t;
+
+// Options
+
+static int format = 0, minTimeMs = 100, nRepeat = 5;
+static int log2Start = 4, log2End = 16;
+static int enablePrec[2] = { 1, 1 }, enableReal[2] = { 1, 1 }, enableDir[2] = { 1, 0 }, enableDim[2] = { 1, 1 };
+static int enablePlan[NPLANS] = { 1, 1, 0, 0, 0 };
+static int threads[64] = { 0 }, nThreads = 1;
+
+static int nResults = 0;
+
+#ifdef USEFFTW
+static int enableFFTW = 0;
+#endif
+
+//
+
+static int compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// The number of iterations is doubled until one repetition takes
+// longer than the minimum time, and the median and the minimum of
+// the repetitions are reported.
+
+static void timeLoop(void (*func)(void *), void *ctx, result_t *r) {
+  for(int i=0;i<2;i++) func(ctx);
+
+  int64_t niter = 1;
+  for(;;) {
+    uint64_t t0 = gettime();
+    for(int64_t i=0;i<niter;i++) func(ctx);
+    uint64_t t1 = gettime();
+    if (t1 - t0 >= (uint64_t)minTimeMs * 1000000 || niter >= ((int64_t)1 << 40)) break;
+    niter *= 2;
+  }
+
+  double t[256];
+  int rep = nRepeat < 256 ? nRepeat : 256;
+  for(int k=0;k<rep;k++) {
+    uint64_t t0 = gettime();
+    for(int64_t i=0;i<niter;i++) func(ctx);
+    uint64_t t1 = gettime();
+    t[k] = (double)(t1 - t0) / niter;
+  }
+
+  qsort(t, rep, sizeof(double), compareDouble);
+  r->minNs = t[0];
+  r->medianNs = (rep & 1) ? t[rep/2] : (t[rep/2-1] + t[rep/2]) / 2;
+}
+
+// Flop counts follow the convention of FFTW's benchmark
+
+static double flops(const config_t *c) {
+  double n = (double)((int64_t)1 << (c->log2n + c->log2m));
+  return (c->real ? 2.5 : 5) * n * (c->log2n + c->log2m);
+}
+
+static int64_t bufferBytes(const config_t *c) {
+  int64_t n = (int64_t)1 << c->log2n, m = (int64_t)1 << c->log2m;
+  return 2 * (c->real ? n + 2 : 2 * n * m) * (int64_t)c->prec->size;
+}
+
+//
+
+typedef struct {
+  const config_t *c;
+  struct SleefDFT *p;
+  void *in, *out;
+} sleefctx_t;
+
+static void runSleef(void *ctx) {
+  sleefctx_t *s = (sleefctx_t *)ctx;
+  s->c->prec->execute(s->p, s->in, s->out);
+}
+
+static void fillRandom(const prec_t *prec, void *buf, int64_t count) {
+  for(int64_t i=0;i<count;i++) {
+    double v = 2.0 * (rand() / (double)RAND_MAX) - 1;
+    if (prec->size == sizeof(double)) ((double *)buf)[i] = v; else ((float *)buf)[i] = (float)v;
+  }
+}
+
+static int benchSleef(const config_t *c, result_t *r) {
+  const uint32_t n = 1 << c->log2n, m = 1 << c->log2m;
+  const int64_t count = bufferBytes(c) / 2 / c->prec->size;
+
+  uint64_t mode = c->plan->mode | (c->real ? SLEEF_MODE_REAL : SLEEF_MODE_COMPLEX) | (c->backward ? SLEEF_MODE_BACKWARD : SLEEF_MODE_FORWARD);
+  if (c->nThread == 1) mode |= SLEEF_MODE_NO_MT;
+
+#ifdef _OPENMP
+  omp_set_num_threads(c->nThread);
+#endif
+
+  uint64_t t0 = gettime();
+  struct SleefDFT *p = c->dim == 1 ? c->prec->init1d(n, mode) : c->prec->init2d(m, n, mode);
+  uint64_t t1 = gettime();
+  if (p == NULL) return 0;
+
+  sleefctx_t s = { c, p, Sleef_malloc(count * c->prec->size), Sleef_malloc(count * c->prec->size) };
+  fillRandom(c->prec, s.in, count);
+
+  timeLoop(runSleef, &s, r);
+
+  SleefDFT_info info;
+  r->impl = "sleef";
+  r->planNs = (double)(t1 - t0);
+  r->isa = "";
+  r->planBytes = -1;
+  if (SleefDFT_getInfo(p, &info) == 0) {
+    r->isa = info.isaName;
+    r->planBytes = (int64_t)(info.tableBytes + info.scratchBytes);
+  }
+
+  SleefDFT_dispose(p);
+  Sleef_free(s.in);
+  Sleef_free(s.out);
+
+  return 1;
+}
+
+#ifdef USEFFTW
+typedef struct {
+  const config_t *c;
+  void *plan;
+} fftwctx_t;
+
+static void runFFTW(void *ctx) {
+  fftwctx_t *f = (fftwctx_t *)ctx;
+#ifdef USEFFTWF
+  if (f->c->prec->size == sizeof(float)) { fftwf_execute((fftwf_plan)f->plan); return; }
+#endif
+  fftw_execute((fftw_plan)f->plan);
+}
+
+// FFTW is measured with a single thread, and only for the precisions
+// whose FFTW library was found at configuration time
+
+static int benchFFTW(const config_t *c, result_t *r) {
+  const int n = 1 << c->log2n, m = 1 << c->log2m;
+  const int64_t count = bufferBytes(c) / 2 / c->prec->size;
+  const unsigned flags = c->plan->mode == SLEEF_MODE_ESTIMATE ? FFTW_ESTIMATE :
+    c->plan->mode == SLEEF_MODE_PATIENT ? FFTW_PATIENT : c->plan->mode == SLEEF_MODE_EXHAUSTIVE ? FFTW_EXHAUSTIVE : FFTW_MEASURE;
+  const int sign = c->backward ? FFTW_BACKWARD : FFTW_FORWARD;
+
+  if (c->nThread > 1) return 0;
+
+  fftwctx_t f = { c, NULL };
+  void *in, *out;
+  uint64_t t0 = 0, t1 = 0;
+
+  if (c->prec->size == sizeof(double)) {
+    in = fftw_malloc(count * sizeof(double));
+    out = fftw_malloc(count * sizeof(double));
+    t0 = gettime();
+    if (c->dim == 2) {
+      f.plan = fftw_plan_dft_2d(m, n, (fftw_complex *)in, (fftw_complex *)out, sign, flags);
+    } else if (!c->real) {
+      f.plan = fftw_plan_dft_1d(n, (fftw_complex *)in, (fftw_complex *)out, sign, flags);
+    } else if (!c->backward) {
+      f.plan = fftw_plan_dft_r2c_1d(n, (double *)in, (fftw_complex *)out, flags);
+    } else {
+      f.plan = fftw_plan_dft_c2r_1d(n, (fftw_complex *)in, (double *)out, flags);
+    }
+    t1 = gettime();
+  } else {
+#ifdef USEFFTWF
+    in = fftwf_malloc(count * sizeof(float));
+    out = fftwf_malloc(count * sizeof(float));
+    t0 = gettime();
+    if (c->dim == 2) {
+      f.plan = fftwf_plan_dft_2d(m, n, (fftwf_complex *)in, (fftwf_complex *)out, sign, flags);
+    } else if (!c->real) {
+      f.plan = fftwf_plan_dft_1d(n, (fftwf_complex *)in, (fftwf_complex *)out, sign, flags);
+    } else if (!c->backward) {
+      f.plan = fftwf_plan_dft_r2c_1d(n, (float *)in, (fftwf_complex *)out, flags);
+    } else {
+      f.plan = fftwf_plan_dft_c2r_1d(n, (fftwf_complex *)in, (float *)out, flags);
+    }
+    t1 = gettime();
+#else
+    return 0;
+#endif
+  }
+
+  // Planning with FFTW_MEASURE overwrites the buffers
+  fillRandom(c->prec, in, count);
+
+  timeLoop(runFFTW, &f, r);
+
+  r->impl = "fftw";
+  r->isa = "";
+  r->planNs = (double)(t1 - t0);
+  r->planBytes = -1;
+
+  if (c->prec->size == sizeof(double)) {
+    fftw_destroy_plan((fftw_plan)f.plan);
+    fftw_free(in);
+    fftw_free(out);
+  } else {
+#ifdef USEFFTWF
+    fftwf_destroy_plan((fftwf_plan)f.plan);
+    fftwf_free(in);
+    fftwf_free(out);
+#endif
+  }
+
+  return 1;
+}
+#endif
+
+//
+
+static void printHeader() {
+  if (format == 0) {
+    printf("impl,prec,type,dir,dim,n,m,threads,plan,isa,plan_ns,median_ns,min_ns,gflops,plan_bytes,buffer_bytes\n");
+  } else {
+    printf("{\n  \"results\": [");
+  }
+}
+
+static void printResult(const config_t *c, const result_t *r) {
+  const int n = 1 << c->log2n, m = 1 << c->log2m;
+  const char *type = c->real ? "real" : "complex", *dir = c->backward ? "backward" : "forward";
+
+  if (format == 0) {
+    printf("%s,%s,%s,%s,%d,%d,%d,%d,%s,%s,%.0f,%.3f,%.3f,%.4f,", r->impl, c->prec->name, type, dir, c->dim, n, m,
+	   c->nThread, c->plan->name, r->isa, r->planNs, r->medianNs, r->minNs, r->gflops);
+    if (r->planBytes >= 0) printf("%lld", (long long)r->planBytes);
+    printf(",%lld\n", (long long)r->bufferBytes);
+  } else {
+    printf("%s\n    { \"impl\": \"%s\", \"prec\": \"%s\", \"type\": \"%s\", \"dir\": \"%s\", \"dim\": %d, \"n\": %d, \"m\": %d, "
+	   "\"threads\": %d, \"plan\": \"%s\", \"isa\": \"%s\", \"plan_ns\": %.0f, \"median_ns\": %.3f, \"min_ns\": %.3f, \"gflops\": %.4f, ",
+	   nResults == 0 ? "" : ",", r->impl, c->prec->name, type, dir, c->dim, n, m,
+	   c->nThread, c->plan->name, r->isa, r->planNs, r->medianNs, r->minNs, r->gflops);
+    if (r->planBytes >= 0) printf("\"plan_bytes\": %lld, ", (long long)r->planBytes); else printf("\"plan_bytes\": null, ");
+    printf("\"buffer_bytes\": %lld }", (long long)r->bufferBytes);
+  }
+
+  fflush(stdout);
+  nResults++;
+}
+
+static void printFooter() {
+  if (format != 0) printf("\n  ]\n}\n");
+}
+
+static void bench(const config_t *c) {
+  result_t r;
+
+  memset(&r, 0, sizeof(r));
+  if (benchSleef(c, &r)) {
+    r.gflops = flops(c) / r.medianNs;
+    r.bufferBytes = bufferBytes(c);
+    printResult(c, &r);
+  }
+
+#ifdef USEFFTW
+  memset(&r, 0, sizeof(r));
+  if (enableFFTW && benchFFTW(c, &r)) {
+    r.gflops = flops(c) / r.medianNs;
+    r.bufferBytes = bufferBytes(c);
+    printResult(c, &r);
+  }
+#endif
+}
+
+//
+
+// Parses a comma-separated list, and sets flags[i] if names[i] appears in it
+
+static int parseList(const char *arg, const char **names, int *flags, int nNames) {
+  for(int i=0;i<nNames;i++) flags[i] = 0;
+
+  char buf[256];
+  strncpy(buf, arg, sizeof(buf)-1);
+  buf[sizeof(buf)-1] = '\0';
+
+  for(char *tok = strtok(buf, ",");tok != NULL;tok = strtok(NULL, ",")) {
+    int i;
+    for(i=0;i<nNames;i++) if (strcmp(tok, names[i]) == 0) break;
+    if (i == nNames) return 0;
+    flags[i] = 1;
+  }
+
+  return 1;
+}
+
+static void showUsage(const char *argv0) {
+  fprintf(stderr, "Usage : %s [options]\n\n", argv0);
+  fprintf(stderr, "  -format csv|json          Output format (default csv)\n");
+  fprintf(stderr, "  -prec dp,sp               Precisions (default dp,sp)\n");
+  fprintf(stderr, "  -type complex,real        Kinds of transform (default complex,real)\n");
+  fprintf(stderr, "  -dir forward,backward     Directions (default forward)\n");
+  fprintf(stderr, "  -dim 1,2                  Dimensions (default 1,2)\n");
+  fprintf(stderr, "  -log2n <start>[:<end>]    Range of log2 of the total size (default 4:16)\n");
+  fprintf(stderr, "  -threads <t>[,<t>...]     Thread counts, 0 for the default (default 0)\n");
+  fprintf(stderr, "  -plan <mode>[,<mode>...]  estimate, measure, quick, patient, exhaustive (default estimate,measure)\n");
+  fprintf(stderr, "  -time <ms>                Minimum time of each repetition (default 100)\n");
+  fprintf(stderr, "  -repeat <k>               Number of repetitions (default 5)\n");
+#ifdef USEFFTW
+  fprintf(stderr, "  -fftw                     Measure FFTW with the same parameters\n");
+#endif
+  exit(-1);
+}
+
+int main(int argc, char **argv) {
+  static const char *precNames[] = { "dp", "sp" }, *typeNames[] = { "complex", "real" };
+  static const char *dirNames[] = { "forward", "backward" }, *dimNames[] = { "1", "2" };
+  const char *planNames[NPLANS];
+  for(int i=0;i<NPLANS;i++) planNames[i] = plans[i].name;
+
+  for(int i=1;i<argc;i++) {
+    if (strcmp(argv[i], "-fftw") == 0) {
+#ifdef USEFFTW
+      enableFFTW = 1;
+      continue;
+#else
+      fprintf(stderr, "%s : not built with FFTW\n", argv[0]);
+      exit(-1);
+#endif
+    }
+
+    if (i + 1 >= argc) showUsage(argv[0]);
+    const char *opt = argv[i], *arg = argv[++i];
+    int ok = 1;
+
+    if (strcmp(opt, "-format") == 0) {
+      format = strcmp(arg, "json") == 0 ? 1 : 0;
+      ok = format == 1 || strcmp(arg, "csv") == 0;
+    } else if (strcmp(opt, "-prec") == 0) {
+      ok = parseList(arg, precNames, enablePrec, 2);
+    } else if (strcmp(opt, "-type") == 0) {
+      ok = parseList(arg, typeNames, enableReal, 2);
+    } else if (strcmp(opt, "-dir") == 0) {
+      ok = parseList(arg, dirNames, enableDir, 2);
+    } else if (strcmp(opt, "-dim") == 0) {
+      ok = parseList(arg, dimNames, enableDim, 2);
+    } else if (strcmp(opt, "-plan") == 0) {
+      ok = parseList(arg, planNames, enablePlan, NPLANS);
+    } else if (strcmp(opt, "-log2n") == 0) {
+      const char *colon = strchr(arg, ':');
+      log2Start = atoi(arg);
+      log2End = colon != NULL ? atoi(colon + 1) : log2Start;
+      ok = 1 <= log2Start && log2Start <= log2End && log2End <= 30;
+    } else if (strcmp(opt, "-threads") == 0) {
+      nThreads = 0;
+      for(const char *s = arg;s != NULL && nThreads < 64;s = strchr(s, ',')) {
+	if (*s == ',') s++;
+	threads[nThreads++] = atoi(s);
+      }
+    } else if (strcmp(opt, "-time") == 0) {
+      minTimeMs = atoi(arg);
+      ok = minTimeMs >= 0;
+    } else if (strcmp(opt, "-repeat") == 0) {
+      nRepeat = atoi(arg);
+      ok = nRepeat >= 1;
+    } else {
+      ok = 0;
+    }
+
+    if (!ok) showUsage(argv[0]);
+  }
+
+#ifdef _OPENMP
+  // A thread count of 0 stands for the default number of threads
+  for(int t=0;t<nThreads;t++) if (threads[t] <= 0) threads[t] = omp_get_max_threads();
+#endif
+
+  // Plans are measured from scratch in every run
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+
+  printHeader();
+
+  for(int dim=1;dim<=2;dim++) {
+    if (!enableDim[dim-1]) continue;
+    for(int real=0;real<2;real++) {
+      // 2D real transforms are not supported
+      if (!enableReal[real] || (dim == 2 && real)) continue;
+      for(int log2=log2Start;log2<=log2End;log2++) {
+	// Real transforms need at least 4 points, and 2D transforms at least 2 in each dimension
+	if ((real && log2 < 2) || (dim == 2 && log2 < 2)) continue;
+	for(int pr=0;pr<2;pr++) {
+	  if (!enablePrec[pr]) continue;
+	  for(int backward=0;backward<2;backward++) {
+	    if (!enableDir[backward]) continue;
+	    for(int pl=0;pl<NPLANS;pl++) {
+	      if (!enablePlan[pl]) continue;
+	      for(int t=0;t<nThreads;t++) {
+		config_t c = { &precs[pr], &plans[pl], real, backward, dim,
+		  dim == 1 ? log2 : log2 - log2/2, dim == 1 ? 0 : log2/2, threads[t] };
+		bench(&c);
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  printFooter();
+
+  exit(0);
+}
@@ -0,0 +1,154 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_execute SleefDFT_double_execute
+#define SleefDFT_initGraph SleefDFT_double_initGraph
+#define SleefDFT_addTransform SleefDFT_double_addTransform
+#define SleefDFT_addCallback SleefDFT_double_addCallback
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_execute SleefDFT_float_execute
+#define SleefDFT_initGraph SleefDFT_float_initGraph
+#define SleefDFT_addTransform SleefDFT_float_addTransform
+#define SleefDFT_addCallback SleefDFT_float_addCallback
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// A pipeline of forward transforms of each channel, a stage that mixes
+// adjacent channels, and backward transforms is executed as a graph and
+// compared with executing the same plans one by one.
+
+typedef struct {
+  real *x, *y;
+  int n, nch, c;
+} mix_t;
+
+// Channel c of y is the sum of channels c and c+1 of x
+static void mix(void *arg) {
+  mix_t *m = (mix_t *)arg;
+  int c0 = m->c, c1 = m->c + 1;
+  if (c0 < 0) { c0 = 0; c1 = m->nch; } // all channels in one callback
+  for(int c=c0;c<c1;c++) {
+    const real *a = m->x + (size_t)c * 2 * m->n, *b = m->x + (size_t)((c + 1) % m->nch) * 2 * m->n;
+    real *d = m->y + (size_t)c * 2 * m->n;
+    for(int i=0;i<2*m->n;i++) d[i] = a[i] + b[i];
+  }
+}
+
+static int check(int n, int nch, uint64_t mode, int perChannelMix) {
+  struct SleefDFT *pf = SleefDFT_init1d(n, NULL, NULL, MODE | mode | SLEEF_MODE_FORWARD);
+  struct SleefDFT *pb = SleefDFT_init1d(n, NULL, NULL, MODE | mode | SLEEF_MODE_BACKWARD);
+
+  const size_t size = sizeof(real) * 2 * n * nch;
+  real *sx = (real *)Sleef_malloc(size), *sy = (real *)Sleef_malloc(size);
+  real *sz = (real *)Sleef_malloc(size), *sw = (real *)Sleef_malloc(size);
+  real *rw = (real *)Sleef_malloc(size);
+
+  for(int i=0;i<2*n*nch;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  // Reference
+
+  for(int c=0;c<nch;c++) SleefDFT_execute(pf, sx + (size_t)c*2*n, sy + (size_t)c*2*n);
+  mix_t all = { sy, sz, n, nch, -1 };
+  mix(&all);
+  for(int c=0;c<nch;c++) SleefDFT_execute(pb, sz + (size_t)c*2*n, rw + (size_t)c*2*n);
+
+  // Graph
+
+  memset(sy, 0, size);
+  memset(sz, 0, size);
+
+  struct SleefDFT *g = SleefDFT_initGraph(MODE | (mode & SLEEF_MODE_NO_MT));
+  int *fwd = (int *)malloc(sizeof(int) * nch);
+  mix_t *mx = (mix_t *)malloc(sizeof(mix_t) * nch);
+  int success = 1;
+
+  for(int c=0;c<nch;c++) fwd[c] = SleefDFT_addTransform(g, pf, sx + (size_t)c*2*n, sy + (size_t)c*2*n, 0, NULL);
+
+  if (perChannelMix) {
+    for(int c=0;c<nch;c++) {
+      mx[c] = (mix_t) { sy, sz, n, nch, c };
+      int deps[2] = { fwd[c], fwd[(c + 1) % nch] };
+      int m = SleefDFT_addCallback(g, mix, &mx[c], 2, deps);
+      SleefDFT_addTransform(g, pb, sz + (size_t)c*2*n, sw + (size_t)c*2*n, 1, &m);
+    }
+  } else {
+    int m = SleefDFT_addCallback(g, mix, &all, nch, fwd);
+    for(int c=0;c<nch;c++) SleefDFT_addTransform(g, pb, sz + (size_t)c*2*n, sw + (size_t)c*2*n, 1, &m);
+  }
+
+  // A node can only depend on nodes that were added before it
+  int bad = 1 << 20;
+  if (SleefDFT_addCallback(g, mix, &all, 1, &bad) != -1) success = 0;
+
+  for(int iter=0;iter<3;iter++) {
+    memset(sw, 0, size);
+    SleefDFT_execute(g, NULL, NULL);
+
+    double rmsn = 0, rmsd = 0;
+    for(int i=0;i<2*n*nch;i++) {
+      rmsn += (sw[i] - rw[i]) * (double)(sw[i] - rw[i]);
+      rmsd += rw[i] * (double)rw[i];
+    }
+    if (!(sqrt(rmsn / rmsd) < THRES)) success = 0;
+  }
+
+  printf("n=%d channels=%d mode=%llx %s : %s\n", n, nch, (unsigned long long)mode,
+	 perChannelMix ? "per-channel mix" : "single mix", success ? "OK" : "NG");
+
+  SleefDFT_dispose(g);
+  SleefDFT_dispose(pf);
+  SleefDFT_dispose(pb);
+  free(fwd);
+  free(mx);
+  Sleef_free(sx); Sleef_free(sy); Sleef_free(sz); Sleef_free(sw); Sleef_free(rw);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  for(int perChannelMix=0;perChannelMix<2;perChannelMix++) {
+    success &= check(n, 16, SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT, perChannelMix);
+    success &= check(n, 16, SLEEF_MODE_ESTIMATE, perChannelMix);
+    success &= check(n, 1, SLEEF_MODE_ESTIMATE, perChannelMix);
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,107 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#include "testerutil.h"
+
+// Decodes a finite 16-bit value with the given number of mantissa bits and exponent bias
+
+static float decode(uint16_t h, int mbits, int bias) {
+  int e = (h & 0x7fff) >> mbits, m = h & ((1 << mbits) - 1);
+  float f = e == 0 ? ldexpf((float)m, 1 - bias - mbits) : ldexpf((float)(m | (1 << mbits)), e - bias - mbits);
+  return (h & 0x8000) != 0 ? -f : f;
+}
+
+// Random values between 1/32 and 2 in magnitude
+
+static uint16_t randomValue(int mbits, int bias) {
+  int e = bias - 5 + rand() % 6;
+  return (uint16_t)(((rand() & 1) << 15) | (e << mbits) | (rand() & ((1 << mbits) - 1)));
+}
+
+// Executes the plan for 16-bit data and the plan for float on the
+// decoded input, and compares the results
+
+static int compare(struct SleefDFT *p, struct SleefDFT *q, int nIn, int nOut, const void *arg) {
+  const int bf16 = *(const int *)arg;
+  const int mbits = bf16 ? 7 : 10, bias = bf16 ? 127 : 15;
+  const double thres = bf16 ? 1e-2 : 2e-3;
+
+  uint16_t *hx = (uint16_t *)Sleef_malloc(nIn * sizeof(uint16_t));
+  uint16_t *hy = (uint16_t *)Sleef_malloc(nOut * sizeof(uint16_t));
+  float *sx = (float *)Sleef_malloc(nIn * sizeof(float));
+  float *sy = (float *)Sleef_malloc(nOut * sizeof(float));
+
+  for(int i=0;i<nIn;i++) {
+    hx[i] = randomValue(mbits, bias);
+    sx[i] = decode(hx[i], mbits, bias);
+  }
+
+  SleefDFT_float_execute16(p, hx, hy);
+  SleefDFT_float_execute(q, sx, sy);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<nOut;i++) {
+    double t = decode(hy[i], mbits, bias);
+    rmsn += (t - sy[i]) * (t - sy[i]);
+    rmsd += sy[i] * (double)sy[i];
+  }
+
+  Sleef_free(hx);
+  Sleef_free(hy);
+  Sleef_free(sx);
+  Sleef_free(sy);
+
+  return sqrt(rmsn / rmsd) < thres;
+}
+
+static int check1d16(int n, uint64_t mode, int bf16) {
+  return check1d(n, mode | (bf16 ? SLEEF_MODE_BF16 : SLEEF_MODE_FP16), MODE | mode, compare, &bf16, bf16 ? "bf16" : "fp16");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int log2n = atoi(argv[1]);
+  const int n = 1 << log2n;
+
+  int success = 1;
+
+  for(int bf16=0;bf16<2;bf16++) {
+    for(int i=0;i<4;i++) {
+      success &= check1d16(n, testModes[i] | SLEEF_MODE_ESTIMATE, bf16);
+    }
+    success &= check1d16(n, SLEEF_MODE_FORWARD  | SLEEF_MODE_REAL | SLEEF_MODE_ALT | SLEEF_MODE_ESTIMATE, bf16);
+    success &= check1d16(n, SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL | SLEEF_MODE_ALT | SLEEF_MODE_ESTIMATE, bf16);
+    // The first ISA converts the data without the conversion instructions
+    success &= check1d16(n, testModes[0] | SLEEF_MODE_REPRODUCIBLE, bf16);
+    success &= check1d16(n, testModes[3] | SLEEF_MODE_REPRODUCIBLE, bf16);
+    success &= check1d16(4, SLEEF_MODE_REAL | SLEEF_MODE_ESTIMATE, bf16);
+    success &= check2d(1 << (log2n/2), 1 << (log2n - log2n/2), SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE | (bf16 ? SLEEF_MODE_BF16 : SLEEF_MODE_FP16),
+		       MODE | SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE, compare, &bf16, bf16 ? "bf16" : "fp16");
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,222 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init SleefDFT_double_init1d
+#define SleefDFT_init2d SleefDFT_double_init2d
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#elif BASETYPEID == 2
+#define SleefDFT_init SleefDFT_float_init1d
+#define SleefDFT_init2d SleefDFT_float_init2d
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#else
+#error BASETYPEID not set
+#endif
+
+#define NEXEC 10
+
+static int check(int n, uint64_t mode) {
+  int success = 1;
+
+  real *sx = (real *)Sleef_malloc((n+2)*2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc((n+2)*2 * sizeof(real));
+  for(int i=0;i<(n+2)*2;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  struct SleefDFT *p = SleefDFT_init(n, NULL, NULL, MODE | mode | SLEEF_MODE_COUNTERS);
+
+  SleefDFT_info info;
+  if (SleefDFT_getInfo(p, &info) != 0) {
+    printf("SleefDFT_getInfo failed\n");
+    return 0;
+  }
+
+  int l2l = 0;
+  for(int j=0;j<info.pathLen;j++) l2l += info.path[j];
+
+  char pathStr[256];
+  SleefDFT_getPath(p, pathStr, sizeof(pathStr));
+
+  printf("ISA %s %d bit, path %s, estimated %llu, measured %llu, table %llu bytes, scratch %llu bytes\n",
+	 info.isaName, info.vectorBits, pathStr,
+	 (unsigned long long)info.estimatedTime, (unsigned long long)info.measuredTime,
+	 (unsigned long long)info.tableBytes, (unsigned long long)info.scratchBytes);
+
+  if (info.isaName == NULL || info.vectorBits <= 0 || info.pathLen <= 0 || l2l != info.log2len ||
+      info.tableBytes == 0 || info.scratchBytes == 0) success = 0;
+  if ((mode & SLEEF_MODE_MEASURE) != 0 && info.measuredTime == 0) success = 0;
+  if ((int)strlen(pathStr) != SleefDFT_getPath(p, NULL, 0)) success = 0;
+
+  // The path string is accepted by SleefDFT_setPath
+
+  struct SleefDFT *q = SleefDFT_init(n, NULL, NULL, (mode & SLEEF_MODE_REAL) | SLEEF_MODE_ESTIMATE);
+  SleefDFT_setPath(q, pathStr);
+  char pathStr2[256];
+  SleefDFT_getPath(q, pathStr2, sizeof(pathStr2));
+  if (strcmp(pathStr, pathStr2) != 0) success = 0;
+  if (SleefDFT_getCounters(q, NULL, NULL, 0) != -1) success = 0;
+  SleefDFT_dispose(q);
+
+  // Counters
+
+  for(int i=0;i<NEXEC;i++) SleefDFT_execute(p, sx, sy);
+
+  uint64_t ticks[64], calls[64];
+  int nStage = SleefDFT_getCounters(p, ticks, calls, 64);
+  if (nStage != info.pathLen + ((mode & SLEEF_MODE_REAL) != 0 ? 1 : 0)) success = 0;
+
+  for(int j=0;j<nStage;j++) {
+    printf("stage %d : %llu ticks, %llu calls\n", j, (unsigned long long)ticks[j], (unsigned long long)calls[j]);
+    if (calls[j] != NEXEC) success = 0;
+  }
+
+  SleefDFT_resetCounters(p);
+  SleefDFT_getCounters(p, ticks, calls, 64);
+  for(int j=0;j<nStage;j++) if (ticks[j] != 0 || calls[j] != 0) success = 0;
+
+  SleefDFT_dispose(p);
+  Sleef_free(sx);
+  Sleef_free(sy);
+
+  return success;
+}
+
+// The counts of the initial plan of SLEEF_MODE_ASYNC are carried
+// over to the measured plan if both plans take the same path. The
+// length differs from the other checks, since a plan loaded from the
+// plan map is not measured.
+
+static int checkAsync(int n) {
+  int success = 1;
+
+  real *sx = (real *)Sleef_malloc(n*2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc(n*2 * sizeof(real));
+  for(int i=0;i<n*2;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  struct SleefDFT *p = SleefDFT_init(n, NULL, NULL, MODE | SLEEF_MODE_MEASURE | SLEEF_MODE_ASYNC | SLEEF_MODE_COUNTERS);
+
+  char pathStr0[256], pathStr1[256];
+  SleefDFT_getPath(p, pathStr0, sizeof(pathStr0));
+
+  SleefDFT_info info;
+  uint64_t nExec = 0;
+  time_t t0 = time(NULL);
+  do {
+    for(int i=0;i<NEXEC;i++) SleefDFT_execute(p, sx, sy);
+    nExec += NEXEC;
+    SleefDFT_getInfo(p, &info);
+  } while(info.measuredTime == 0 && time(NULL) - t0 < 60);
+
+  for(int i=0;i<NEXEC;i++) SleefDFT_execute(p, sx, sy);
+  nExec += NEXEC;
+
+  SleefDFT_getPath(p, pathStr1, sizeof(pathStr1));
+
+  uint64_t ticks[64], calls[64];
+  int nStage = SleefDFT_getCounters(p, ticks, calls, 64);
+
+  printf("async path %s -> %s, %llu executions, %llu calls\n", pathStr0, pathStr1,
+	 (unsigned long long)nExec, (unsigned long long)calls[0]);
+
+  if (info.measuredTime == 0 || nStage != info.pathLen) success = 0;
+  for(int j=0;j<nStage;j++) {
+    if (strcmp(pathStr0, pathStr1) == 0 ? calls[j] != nExec : (calls[j] < NEXEC || calls[j] > nExec)) success = 0;
+  }
+
+  SleefDFT_resetCounters(p);
+  SleefDFT_getCounters(p, ticks, calls, 64);
+  for(int j=0;j<nStage;j++) if (ticks[j] != 0 || calls[j] != 0) success = 0;
+
+  SleefDFT_dispose(p);
+  Sleef_free(sx);
+  Sleef_free(sy);
+
+  return success;
+}
+
+// 2D plans report their row and column plans, which keep the counters
+
+static int check2d(int n, int m, uint64_t mode) {
+  int success = 1;
+
+  real *sx = (real *)Sleef_malloc(n*m*2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc(n*m*2 * sizeof(real));
+  for(int i=0;i<n*m*2;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  struct SleefDFT *p = SleefDFT_init2d(n, m, NULL, NULL, MODE | mode | SLEEF_MODE_COUNTERS);
+
+  SleefDFT_info info, h, v;
+  if (SleefDFT_getInfo(p, &info) != 0 || info.rowPlan == NULL || info.columnPlan == NULL ||
+      SleefDFT_getInfo(info.rowPlan, &h) != 0 || SleefDFT_getInfo(info.columnPlan, &v) != 0) {
+    printf("SleefDFT_getInfo failed\n");
+    return 0;
+  }
+
+  printf("2D ISA %s %d bit, transpose %s, estimated %llu, table %llu bytes, scratch %llu bytes\n",
+	 info.isaName, info.vectorBits, info.transposeMT ? "MT" : "ST", (unsigned long long)info.estimatedTime,
+	 (unsigned long long)info.tableBytes, (unsigned long long)info.scratchBytes);
+
+  if (info.isaName == NULL || info.pathLen != 0 || info.log2len != h.log2len + v.log2len ||
+      info.tableBytes < h.tableBytes || info.scratchBytes <= h.scratchBytes) success = 0;
+  if (SleefDFT_getCounters(p, NULL, NULL, 0) != -1) success = 0;
+
+  for(int i=0;i<NEXEC;i++) SleefDFT_execute(p, sx, sy);
+
+  uint64_t ticks[64], calls[64];
+  int nStage = SleefDFT_getCounters(info.rowPlan, ticks, calls, 64);
+  if (nStage != h.pathLen) success = 0;
+  const uint64_t nCall = info.rowPlan == info.columnPlan ? NEXEC * (n + m) : NEXEC * n;
+  for(int j=0;j<nStage;j++) if (calls[j] != nCall) success = 0;
+
+  SleefDFT_resetCounters(p);
+  SleefDFT_getCounters(info.columnPlan, ticks, calls, 64);
+  for(int j=0;j<v.pathLen;j++) if (ticks[j] != 0 || calls[j] != 0) success = 0;
+
+  SleefDFT_dispose(p);
+  Sleef_free(sx);
+  Sleef_free(sy);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  success &= check(n, SLEEF_MODE_ESTIMATE);
+  success &= check(n, SLEEF_MODE_MEASURE);
+  success &= check(n, SLEEF_MODE_MEASURE | SLEEF_MODE_REAL);
+  success &= checkAsync(n * 2);
+  success &= check2d(n, n, SLEEF_MODE_ESTIMATE);
+  success &= check2d(n, n * 2, SLEEF_MODE_ESTIMATE);
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,99 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+#include "sleefdftinline.h"
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_execute SleefDFT_double_execute
+#define INLINEF(n) SleefDFT_double_inlinef ## n
+#define INLINEB(n) SleefDFT_double_inlineb ## n
+typedef double real;
+#define THRES 1e-13
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_execute SleefDFT_float_execute
+#define INLINEF(n) SleefDFT_float_inlinef ## n
+#define INLINEB(n) SleefDFT_float_inlineb ## n
+typedef float real;
+#define THRES 1e-6
+#else
+#error BASETYPEID not set
+#endif
+
+// Compares the inline transforms with the transforms executed with plans
+
+static int check(int n, void (*func)(real *, const real *), uint64_t mode) {
+  real *sx = (real *)Sleef_malloc(n * 2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc(n * 2 * sizeof(real));
+  real *ty = (real *)Sleef_malloc(n * 2 * sizeof(real));
+
+  for(int i=0;i<n*2;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, mode | SLEEF_MODE_ESTIMATE);
+
+  SleefDFT_execute(p, sx, ty);
+  (*func)(sy, sx);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<n*2;i++) {
+    rmsn += (sy[i] - ty[i]) * (double)(sy[i] - ty[i]);
+    rmsd += ty[i] * (double)ty[i];
+  }
+
+  int success = sqrt(rmsn / rmsd) < THRES;
+
+  printf("n=%d %s : %s\n", n, (mode & SLEEF_MODE_BACKWARD) == 0 ? "forward" : "backward", success ? "OK" : "NG");
+
+  SleefDFT_dispose(p);
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  int success = 1;
+
+  success &= check(4, INLINEF(4), SLEEF_MODE_FORWARD);
+  success &= check(4, INLINEB(4), SLEEF_MODE_BACKWARD);
+#if SLEEFDFT_INLINE_MAXLOG2LEN >= 3
+  success &= check(8, INLINEF(8), SLEEF_MODE_FORWARD);
+  success &= check(8, INLINEB(8), SLEEF_MODE_BACKWARD);
+#endif
+#if SLEEFDFT_INLINE_MAXLOG2LEN >= 4
+  success &= check(16, INLINEF(16), SLEEF_MODE_FORWARD);
+  success &= check(16, INLINEB(16), SLEEF_MODE_BACKWARD);
+#endif
+#if SLEEFDFT_INLINE_MAXLOG2LEN >= 5
+  success &= check(32, INLINEF(32), SLEEF_MODE_FORWARD);
+  success &= check(32, INLINEB(32), SLEEF_MODE_BACKWARD);
+#endif
+#if SLEEFDFT_INLINE_MAXLOG2LEN >= 7
+  success &= check(128, INLINEF(128), SLEEF_MODE_FORWARD);
+  success &= check(128, INLINEB(128), SLEEF_MODE_BACKWARD);
+#endif
+#if SLEEFDFT_INLINE_MAXLOG2LEN >= 10
+  success &= check(1024, INLINEF(1024), SLEEF_MODE_FORWARD);
+  success &= check(1024, INLINEB(1024), SLEEF_MODE_BACKWARD);
+#endif
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,143 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#include "testerutil.h"
+
+#if BASETYPEID == 1
+#define SleefDFT_executeInt SleefDFT_double_executeInt
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_executeInt SleefDFT_float_executeInt
+#define THRES 1e-5
+#endif
+
+static int32_t randomSample(int int16) {
+  return int16 ? (int32_t)(rand() % 65536) - 32768 : (int32_t)((((uint32_t)rand() << 16) ^ (uint32_t)rand()) & 0x7fffffff) - 0x40000000;
+}
+
+// Forward transforms of integer samples are compared with the
+// transforms of the samples converted by the caller
+
+static int checkForward(struct SleefDFT *p, struct SleefDFT *q, int nIn, int nOut, const void *arg) {
+  const int int16 = *(const int *)arg;
+  const real scale = int16 ? (real)(1.0 / 32768) : (real)(1.0 / 1073741824.0);
+
+  void *ix = Sleef_malloc(nIn * sizeof(int32_t));
+  real *sx = (real *)Sleef_malloc(nIn * sizeof(real));
+  real *sy = (real *)Sleef_malloc(nOut * sizeof(real));
+  real *ty = (real *)Sleef_malloc(nOut * sizeof(real));
+
+  for(int i=0;i<nIn;i++) {
+    int32_t v = randomSample(int16);
+    if (int16) ((int16_t *)ix)[i] = (int16_t)v; else ((int32_t *)ix)[i] = v;
+    sx[i] = v * scale;
+  }
+
+  SleefDFT_executeInt(p, ix, sy, scale);
+  SleefDFT_execute(q, sx, ty);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<nOut;i++) {
+    rmsn += (sy[i] - ty[i]) * (double)(sy[i] - ty[i]);
+    rmsd += ty[i] * (double)ty[i];
+  }
+
+  Sleef_free(ix);
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+
+  return sqrt(rmsn / rmsd) < THRES;
+}
+
+// Backward transforms are scaled so that some of the outputs
+// saturate, and are compared with the rounded reference values
+
+static int checkBackward(struct SleefDFT *p, struct SleefDFT *q, int nIn, int nOut, const void *arg) {
+  const int int16 = *(const int *)arg;
+  const double maxv = int16 ? INT16_MAX : INT32_MAX, minv = int16 ? INT16_MIN : INT32_MIN;
+
+  real *sx = (real *)Sleef_malloc(nIn * sizeof(real));
+  real *ty = (real *)Sleef_malloc(nOut * sizeof(real));
+  void *iy = Sleef_malloc(nOut * sizeof(int32_t));
+
+  for(int i=0;i<nIn;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  SleefDFT_execute(q, sx, ty);
+
+  double amax = 0;
+  for(int i=0;i<nOut;i++) amax = fmax(amax, fabs((double)ty[i]));
+  const real scale = (real)(1.5 * maxv / amax);
+
+  SleefDFT_executeInt(p, sx, iy, scale);
+
+  int success = 1, nSaturated = 0;
+  for(int i=0;i<nOut;i++) {
+    double e = fmin(fmax(floor((double)ty[i] * scale + 0.5), minv), maxv);
+    double v = int16 ? ((int16_t *)iy)[i] : ((int32_t *)iy)[i];
+    if (e == maxv || e == minv) nSaturated++;
+    if (fabs(v - e) > fmax(1, fabs(e) * THRES)) success = 0;
+  }
+
+  Sleef_free(sx);
+  Sleef_free(ty);
+  Sleef_free(iy);
+
+  return success && nSaturated > 0;
+}
+
+static int check1dInt(int n, uint64_t mode, int int16) {
+  return check1d(n, mode | (int16 ? SLEEF_MODE_INT16 : SLEEF_MODE_INT32), MODE | mode,
+		 (mode & SLEEF_MODE_BACKWARD) == 0 ? checkForward : checkBackward, &int16, int16 ? "int16" : "int32");
+}
+
+static int check2dInt(int n, int m, uint64_t mode, int int16) {
+  return check2d(n, m, mode | (int16 ? SLEEF_MODE_INT16 : SLEEF_MODE_INT32), MODE | mode,
+		 (mode & SLEEF_MODE_BACKWARD) == 0 ? checkForward : checkBackward, &int16, int16 ? "int16" : "int32");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int log2n = atoi(argv[1]);
+  const int n = 1 << log2n;
+
+  int success = 1;
+
+  for(int int16=0;int16<2;int16++) {
+    for(int i=0;i<4;i++) {
+      success &= check1dInt(n, testModes[i] | SLEEF_MODE_ESTIMATE, int16);
+    }
+    // The conversion kernels of the first ISA
+    success &= check1dInt(n, testModes[0] | SLEEF_MODE_REPRODUCIBLE, int16);
+    success &= check1dInt(n, testModes[3] | SLEEF_MODE_REPRODUCIBLE, int16);
+    success &= check1dInt(4, SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL | SLEEF_MODE_ESTIMATE, int16);
+    success &= check2dInt(1 << (log2n/2), 1 << (log2n - log2n/2), SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE, int16);
+    success &= check2dInt(1 << (log2n/2), 1 << (log2n - log2n/2), SLEEF_MODE_BACKWARD | SLEEF_MODE_ESTIMATE, int16);
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -13,6 +13,11 @@
 #include <complex.h>
 
 #include "sleef.h"
+
+#if BASETYPEID == 4
+#include "quaddef.h"
+#endif
+
 #include "sleefdft.h"
 #include "misc.h"
 
@@ -45,7 +50,7 @@ cmpl omega(double n, double kn) {
 #elif BASETYPEID == 3
 #define SleefDFT_init SleefDFT_longdouble_init1d
 #define SleefDFT_execute SleefDFT_longdouble_execute
-typedef double real;
+typedef long double real;
 
 typedef double complex cmpl;
 
@@ -53,8 +58,6 @@ cmpl omega(double n, double kn) {
   return cexp((-2 * M_PIl * _Complex_I / n) * kn);
 }
 #elif BASETYPEID == 4
-#include <quadmath.h>
-
 #define SleefDFT_init SleefDFT_quad_init1d
 #define SleefDFT_execute SleefDFT_quad_execute
 typedef Sleef_quad real;
@@ -0,0 +1,177 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define THRES 1e-28
+#define SleefDFT_init SleefDFT_double_init1d
+#define SleefDFT_execute SleefDFT_double_execute
+#define SleefDFT_initOutOfCore SleefDFT_double_init1dOutOfCore
+#define SleefDFT_executeOutOfCore SleefDFT_double_executeOutOfCore
+#define SleefDFT_executeFile SleefDFT_double_executeFile
+typedef double real;
+#elif BASETYPEID == 2
+#define THRES 1e-11
+#define SleefDFT_init SleefDFT_float_init1d
+#define SleefDFT_execute SleefDFT_float_execute
+#define SleefDFT_initOutOfCore SleefDFT_float_init1dOutOfCore
+#define SleefDFT_executeOutOfCore SleefDFT_float_executeOutOfCore
+#define SleefDFT_executeFile SleefDFT_float_executeFile
+typedef float real;
+#else
+#error BASETYPEID not set
+#endif
+
+static double squ(double x) { return x * x; }
+
+typedef struct {
+  const real *in;
+  real *out;
+} memio_t;
+
+static int memRead(void *ctx, int target, uint64_t offset, void *buf, uint64_t size) {
+  memio_t *m = (memio_t *)ctx;
+  memcpy(buf, (target == SLEEF_OOC_INPUT ? (const char *)m->in : (const char *)m->out) + offset, size);
+  return 0;
+}
+
+static int memWrite(void *ctx, uint64_t offset, const void *buf, uint64_t size) {
+  memio_t *m = (memio_t *)ctx;
+  memcpy((char *)m->out + offset, buf, size);
+  return 0;
+}
+
+static double compare(const real *x, const real *y, int n) {
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<n*2;i++) {
+    rmsn += squ(x[i] - y[i]);
+    rmsd += squ(y[i]);
+  }
+  return rmsn / rmsd;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "%s <log2n> <memlimit in KiB>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+  const uint64_t memLimit = (uint64_t)atoi(argv[2]) * 1024;
+
+  srand((unsigned int)time(NULL));
+
+  real *sx = (real *)Sleef_malloc(n*2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc(n*2 * sizeof(real));
+  real *sz = (real *)Sleef_malloc(n*2 * sizeof(real));
+
+  for(int i=0;i<n*2;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  int success = 1;
+
+  // Reference
+
+  struct SleefDFT *p = SleefDFT_init(n, NULL, NULL, SLEEF_MODE_ESTIMATE);
+  SleefDFT_execute(p, sx, sy);
+  SleefDFT_dispose(p);
+
+  // Forward transform on files
+
+  char inPath[256], outPath[256];
+  sprintf(inPath,  "ooctest%d_in.%d.tmp" , BASETYPEID, n);
+  sprintf(outPath, "ooctest%d_out.%d.tmp", BASETYPEID, n);
+
+  FILE *fp = fopen(inPath, "wb");
+  if (fp == NULL || fwrite(sx, sizeof(real)*2, n, fp) != (size_t)n) {
+    printf("Could not write %s\n", inPath);
+    exit(-1);
+  }
+  fclose(fp);
+
+  p = SleefDFT_initOutOfCore(n, memLimit, MODE | SLEEF_MODE_ESTIMATE);
+
+  if (p == NULL) {
+    printf("SleefDFT initialization failed\n");
+    exit(-1);
+  }
+
+  if (SleefDFT_executeFile(p, inPath, outPath) != 0) {
+    printf("SleefDFT_executeFile failed\n");
+    exit(-1);
+  }
+  SleefDFT_dispose(p);
+
+  fp = fopen(outPath, "rb");
+  if (fp == NULL || fread(sz, sizeof(real)*2, n, fp) != (size_t)n) {
+    printf("Could not read %s\n", outPath);
+    exit(-1);
+  }
+  fclose(fp);
+
+  remove(inPath);
+  remove(outPath);
+
+  double e = compare(sz, sy, n);
+  if (e > THRES) success = 0;
+  printf("file forward : %g\n", e);
+
+  // Backward transform with callbacks
+
+  p = SleefDFT_initOutOfCore(n, memLimit, MODE | SLEEF_MODE_ESTIMATE | SLEEF_MODE_BACKWARD);
+
+  if (p == NULL) {
+    printf("SleefDFT initialization failed\n");
+    exit(-1);
+  }
+
+  memio_t m = { sy, sz };
+  if (SleefDFT_executeOutOfCore(p, memRead, memWrite, &m) != 0) {
+    printf("SleefDFT_executeOutOfCore failed\n");
+    exit(-1);
+  }
+  SleefDFT_dispose(p);
+
+  for(int i=0;i<n*2;i++) sz[i] *= (real)(1.0 / n);
+
+  e = compare(sz, sx, n);
+  if (e > THRES) success = 0;
+  printf("callback backward : %g\n", e);
+
+  // Unsupported modes are rejected
+
+  p = SleefDFT_initOutOfCore(n, memLimit, MODE | SLEEF_MODE_ESTIMATE | SLEEF_MODE_ALT);
+  if (p != NULL) {
+    printf("SLEEF_MODE_ALT was not rejected\n");
+    SleefDFT_dispose(p);
+    success = 0;
+  }
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(sz);
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,234 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Performance regression test. A transform is timed several times,
+// and the median and its confidence interval are compared with the
+// entry for the same transform in a baseline file. The test fails if
+// the whole confidence interval lies above the baseline median by more
+// than the tolerance even after retries. A missing entry is added to
+// the baseline file, and is replaced if SLEEFDFT_PERF_UPDATE is set.
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#define NREPEAT 15
+#define REPEATNS 20000000
+#define NRETRY 2
+#define MAXLINES 1024
+
+static uint64_t gettime() {
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return (uint64_t)tp.tv_sec * 1000000000 + ((uint64_t)tp.tv_nsec);
+}
+
+static int compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// Returns the largest k such that P(X < k) <= alpha/2 for X ~
+// Binomial(n, 1/2). The k-th smallest and the k-th largest of n
+// samples then bound the median with confidence at least 1 - alpha.
+
+static int medianCIRank(int n, double alpha) {
+  double p = pow(0.5, n), cdf = 0;
+  int k = 0;
+  for(;;) {
+    if (cdf + p > alpha / 2) break;
+    cdf += p;
+    p = p * (n - k) / (k + 1);
+    k++;
+  }
+  return k < 1 ? 1 : k;
+}
+
+//
+
+static struct SleefDFT *plan;
+static void *bufIn, *bufOut;
+static int isDP;
+
+static void run(int64_t niter) {
+  if (isDP) {
+    for(int64_t i=0;i<niter;i++) SleefDFT_double_execute(plan, (double *)bufIn, (double *)bufOut);
+  } else {
+    for(int64_t i=0;i<niter;i++) SleefDFT_float_execute(plan, (float *)bufIn, (float *)bufOut);
+  }
+}
+
+// Times NREPEAT repetitions of about REPEATNS nanoseconds each, and
+// returns the median time per transform and its confidence interval
+
+static void measure(double *median, double *lo, double *hi) {
+  int64_t niter = 1;
+  for(;;) {
+    uint64_t t0 = gettime();
+    run(niter);
+    uint64_t t1 = gettime();
+    if (t1 - t0 >= REPEATNS / 4) { niter = niter * REPEATNS / (t1 - t0 + 1) + 1; break; }
+    niter *= 2;
+  }
+
+  double t[NREPEAT];
+  for(int k=0;k<NREPEAT;k++) {
+    uint64_t t0 = gettime();
+    run(niter);
+    uint64_t t1 = gettime();
+    t[k] = (double)(t1 - t0) / niter;
+  }
+
+  qsort(t, NREPEAT, sizeof(double), compareDouble);
+  const int k = medianCIRank(NREPEAT, 0.05);
+  *median = t[NREPEAT/2];
+  *lo = t[k-1];
+  *hi = t[NREPEAT-k];
+}
+
+//
+
+static char *lines[MAXLINES];
+static int nLines = 0;
+
+static void readBaseline(const char *path) {
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) return;
+
+  char buf[1024];
+  while(nLines < MAXLINES && fgets(buf, sizeof(buf), fp) != NULL) {
+    if (buf[0] == '\n' || buf[0] == '\0') continue;
+    lines[nLines++] = strdup(buf);
+  }
+
+  fclose(fp);
+}
+
+static int findBaseline(const char *name, double *median) {
+  char key[256];
+  for(int i=0;i<nLines;i++) {
+    if (sscanf(lines[i], "%255s %lf", key, median) == 2 && strcmp(key, name) == 0) return i;
+  }
+  return -1;
+}
+
+static int writeBaseline(const char *path) {
+  FILE *fp = fopen(path, "w");
+  if (fp == NULL) return 0;
+  for(int i=0;i<nLines;i++) fputs(lines[i], fp);
+  fclose(fp);
+  return 1;
+}
+
+//
+
+int main(int argc, char **argv) {
+  if (argc < 6) {
+    fprintf(stderr, "%s <baseline file> <tolerance percent> dp|sp complex|real <log2n> [<log2m>]\n", argv[0]);
+    exit(-1);
+  }
+
+  const char *path = argv[1];
+  const double tolerance = atof(argv[2]) / 100;
+  isDP = strcmp(argv[3], "dp") == 0;
+  const int real = strcmp(argv[4], "real") == 0;
+  const int log2n = atoi(argv[5]), log2m = argc >= 7 ? atoi(argv[6]) : 0;
+  const int n = 1 << log2n, m = 1 << log2m;
+
+#ifdef __linux__
+  // Pin to the current core so that the thread is not migrated during measurement
+  const int cpu = sched_getcpu();
+  if (cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+#endif
+
+  char name[256];
+  if (argc >= 7) {
+    snprintf(name, sizeof(name), "%s-%s-%dx%d", argv[3], argv[4], m, n);
+  } else {
+    snprintf(name, sizeof(name), "%s-%s-%d", argv[3], argv[4], n);
+  }
+
+  const uint64_t mode = SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT | (real ? SLEEF_MODE_REAL : SLEEF_MODE_COMPLEX);
+  const size_t size = (isDP ? sizeof(double) : sizeof(float)) * (real ? n + 2 : 2 * (size_t)n * m);
+
+  bufIn = Sleef_malloc(size);
+  bufOut = Sleef_malloc(size);
+  memset(bufIn, 0, size);
+  for(int i=0;i<n;i++) {
+    if (isDP) ((double *)bufIn)[i] = 2.0 * (rand() / (double)RAND_MAX) - 1;
+    else ((float *)bufIn)[i] = (float)(2.0 * (rand() / (double)RAND_MAX) - 1);
+  }
+
+  if (argc >= 7) {
+    plan = isDP ? SleefDFT_double_init2d(m, n, NULL, NULL, mode) : SleefDFT_float_init2d(m, n, NULL, NULL, mode);
+  } else {
+    plan = isDP ? SleefDFT_double_init1d(n, NULL, NULL, mode) : SleefDFT_float_init1d(n, NULL, NULL, mode);
+  }
+
+  double median, lo, hi;
+  measure(&median, &lo, &hi);
+  printf("%s : median %.3f ns, 95%% CI [%.3f, %.3f]\n", name, median, lo, hi);
+
+  readBaseline(path);
+
+  char line[512];
+  snprintf(line, sizeof(line), "%s %.3f %.3f %.3f\n", name, median, lo, hi);
+
+  double base;
+  const int idx = findBaseline(name, &base);
+
+  if (idx < 0 || getenv("SLEEFDFT_PERF_UPDATE") != NULL) {
+    if (idx < 0) {
+      if (nLines >= MAXLINES) { fprintf(stderr, "Too many entries in %s\n", path); exit(-1); }
+      lines[nLines++] = strdup(line);
+    } else {
+      free(lines[idx]);
+      lines[idx] = strdup(line);
+    }
+    if (!writeBaseline(path)) { fprintf(stderr, "Could not write %s\n", path); exit(-1); }
+    printf("Baseline recorded in %s\n", path);
+    exit(0);
+  }
+
+  const double limit = base * (1 + tolerance);
+  printf("Baseline median %.3f ns, limit %.3f ns\n", base, limit);
+
+  // A slowdown has to be reproduced before the test fails, since a
+  // single measurement can be disturbed by other processes
+
+  for(int retry=0;lo > limit && retry < NRETRY;retry++) {
+    measure(&median, &lo, &hi);
+    printf("Retry : median %.3f ns, 95%% CI [%.3f, %.3f]\n", median, lo, hi);
+  }
+
+  SleefDFT_dispose(plan);
+  Sleef_free(bufIn);
+  Sleef_free(bufOut);
+
+  if (lo > limit) {
+    printf("NG : %.1f%% slower than the baseline\n", (median / base - 1) * 100);
+    exit(-1);
+  }
+
+  printf("OK\n");
+  exit(0);
+}
@@ -0,0 +1,131 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define THRES 1e-30
+#define SleefDFT_init SleefDFT_double_init1d
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#elif BASETYPEID == 2
+#define THRES 1e-13
+#define SleefDFT_init SleefDFT_float_init1d
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#else
+#error BASETYPEID not set
+#endif
+
+static double squ(double x) { return x * x; }
+
+static double timeInit(int n, struct SleefDFT **pp, uint64_t mode) {
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  *pp = SleefDFT_init(n, NULL, NULL, mode);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+}
+
+static int roundtrip(int n) {
+  real *sx = (real *)Sleef_malloc(n*2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc(n*2 * sizeof(real));
+  real *sz = (real *)Sleef_malloc(n*2 * sizeof(real));
+
+  for(int i=0;i<n*2;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  struct SleefDFT *pf = SleefDFT_init(n, NULL, NULL, MODE | SLEEF_MODE_MEASURE);
+  struct SleefDFT *pb = SleefDFT_init(n, NULL, NULL, MODE | SLEEF_MODE_MEASURE | SLEEF_MODE_BACKWARD);
+  SleefDFT_execute(pf, sx, sy);
+  SleefDFT_execute(pb, sy, sz);
+  SleefDFT_dispose(pf);
+  SleefDFT_dispose(pb);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<n*2;i++) {
+    rmsn += squ(sz[i] / n - sx[i]);
+    rmsd += squ(sx[i]);
+  }
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(sz);
+
+  return rmsn / rmsd < THRES;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  srand((unsigned int)time(NULL));
+
+  int success = 1;
+
+  // Plans are kept only in memory
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+
+  struct SleefDFT *p;
+  double tMeasure = timeInit(n, &p, MODE | SLEEF_MODE_MEASURE);
+  SleefDFT_dispose(p);
+
+  size_t size = SleefDFT_exportPlans(NULL, 0);
+  void *buf = malloc(size);
+  if (SleefDFT_exportPlans(buf, size) != size) success = 0;
+  printf("exported %d bytes\n", (int)size);
+
+  // Start over with an empty plan map and import the exported plans
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+
+  size_t emptySize = SleefDFT_exportPlans(NULL, 0);
+  if (emptySize >= size) success = 0;
+
+  int nImported = SleefDFT_importPlans(buf, size);
+  printf("imported %d entries\n", nImported);
+  if (nImported <= 0 || SleefDFT_exportPlans(NULL, 0) != size) success = 0;
+
+  // Initialization should now reuse the imported plan
+
+  double tLoaded = timeInit(n, &p, MODE | SLEEF_MODE_MEASURE);
+  SleefDFT_dispose(p);
+  printf("init : measured %g sec, imported %g sec\n", tMeasure, tLoaded);
+  if (!(tLoaded < tMeasure * 0.5)) success = 0;
+
+  // Broken images are rejected
+
+  ((unsigned char *)buf)[size-1] ^= 1;
+  if (SleefDFT_importPlans(buf, size) != -1) success = 0;
+  if (SleefDFT_importPlans(buf, size-1) != -1) success = 0;
+  free(buf);
+
+  if (!roundtrip(n)) success = 0;
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
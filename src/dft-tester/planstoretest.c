@@ -0,0 +1,291 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+#include "planstore.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init SleefDFT_double_init1d
+#elif BASETYPEID == 2
+#define SleefDFT_init SleefDFT_float_init1d
+#else
+#error BASETYPEID not set
+#endif
+
+// The layout of the header and the records in planstore.c
+
+typedef struct {
+  char magic[8];
+  uint32_t version, recordSize;
+  uint64_t nSorted;
+  uint64_t endianCheck;
+  uint64_t reserved[4];
+} header_t;
+
+typedef struct {
+  uint64_t arch, key, value, check;
+} record_t;
+
+#define COMPACTION_THRESHOLD 256
+
+static char fn[256];
+
+static int readHeader(header_t *h, long *size) {
+  FILE *fp = fopen(fn, "rb");
+  if (fp == NULL) return 0;
+  int ok = fread(h, sizeof(*h), 1, fp) == 1;
+  fseek(fp, 0, SEEK_END);
+  *size = ftell(fp);
+  fclose(fp);
+  return ok;
+}
+
+static void appendRaw(const void *ptr, size_t size) {
+  FILE *fp = fopen(fn, "ab");
+  fwrite(ptr, size, 1, fp);
+  fclose(fp);
+}
+
+static uint64_t get(uint64_t arch, uint64_t key) {
+  uint64_t value = 0;
+  PlanStore *ps = PlanStore_open(fn);
+  if (ps == NULL) return 0;
+  if (!PlanStore_get(ps, arch, key, &value)) value = 0;
+  PlanStore_close(ps);
+  return value;
+}
+
+// The records are appended, overridden, compacted and removed through
+// the functions in planstore.c
+
+static int checkStore() {
+  int success = 1;
+  const uint64_t arch = PlanStore_hashString("planstoretest");
+  uint64_t keys[COMPACTION_THRESHOLD+64], values[COMPACTION_THRESHOLD+64];
+  header_t h;
+  long size;
+
+  remove(fn);
+
+  for(int i=0;i<10;i++) { keys[i] = i; values[i] = i * 10 + 1; }
+  if (PlanStore_append(fn, arch, keys, values, 10) != 0) success = 0;
+
+  if (!readHeader(&h, &size) || memcmp(h.magic, "SLEEFPS", 8) != 0 || h.version != 1 ||
+      h.recordSize != sizeof(record_t) || h.nSorted != 0 || size != (long)(sizeof(h) + sizeof(record_t) * 10)) {
+    printf("Header of a new store : NG\n");
+    success = 0;
+  }
+  if (!PlanStore_isPlanStore(fn) || get(arch, 3) != 31 || get(arch + 1, 3) != 0) {
+    printf("Lookup : NG\n");
+    success = 0;
+  }
+
+  // A later record overrides an earlier one with the same key
+
+  keys[0] = 3; values[0] = 32;
+  PlanStore_append(fn, arch, keys, values, 1);
+  if (get(arch, 3) != 32) {
+    printf("Override in the tail : NG\n");
+    success = 0;
+  }
+
+  // Appending past the threshold sorts the records into a new file
+
+  for(int i=0;i<COMPACTION_THRESHOLD+64;i++) { keys[i] = 1000 + i; values[i] = i + 1; }
+  PlanStore_append(fn, arch, keys, values, COMPACTION_THRESHOLD+64);
+
+  if (!readHeader(&h, &size) || h.nSorted != 10 + COMPACTION_THRESHOLD+64 ||
+      size != (long)(sizeof(h) + sizeof(record_t) * h.nSorted) || get(arch, 3) != 32 || get(arch, 1100) != 101) {
+    printf("Compaction : NG\n");
+    success = 0;
+  }
+
+  // The tail takes precedence over the sorted records
+
+  keys[0] = 3; values[0] = 33;
+  PlanStore_append(fn, arch, keys, values, 1);
+  if (get(arch, 3) != 33) {
+    printf("Tail over sorted records : NG\n");
+    success = 0;
+  }
+
+  // Torn and corrupted records are ignored
+
+  record_t r = { arch, 3, 34, 0 };
+  appendRaw(&r, sizeof(r));
+  appendRaw(&r, sizeof(r) / 2);
+  if (get(arch, 3) != 33 || get(arch, 5) != 51) {
+    printf("Corrupted records : NG\n");
+    success = 0;
+  }
+
+  // The records of an architecture are removed
+
+  keys[0] = 3; values[0] = 35;
+  PlanStore_append(fn, arch + 1, keys, values, 1);
+  PlanStore_compact(fn, 1, arch);
+  if (get(arch, 3) != 0 || get(arch, 1100) != 0 || get(arch + 1, 3) != 35) {
+    printf("Removal of an architecture : NG\n");
+    success = 0;
+  }
+
+  remove(fn);
+
+  return success;
+}
+
+// Initializes a plan, and tells whether it printed the message in
+// SLEEF_MODE_VERBOSE
+
+static int initPlanMsg(int n, uint64_t mode, const char *msg, char *path, int size) {
+  fflush(stdout);
+  int fd = dup(1);
+  FILE *fp = tmpfile();
+  dup2(fileno(fp), 1);
+
+  struct SleefDFT *p = SleefDFT_init(n, NULL, NULL, MODE | SLEEF_MODE_VERBOSE | mode);
+
+  fflush(stdout);
+  dup2(fd, 1);
+  close(fd);
+
+  int loaded = 0;
+  char line[1024];
+  rewind(fp);
+  while(fgets(line, sizeof(line), fp) != NULL) if (strstr(line, msg) != NULL) loaded = 1;
+  fclose(fp);
+
+  if (path != NULL) SleefDFT_getPath(p, path, size);
+  SleefDFT_dispose(p);
+
+  return loaded;
+}
+
+// Whether the path of a measured plan was loaded
+static int initPlan(int n, char *path, int size) {
+  return initPlanMsg(n, SLEEF_MODE_MEASURE, "Path(loaded)", path, size);
+}
+
+// Plans are saved to and loaded from a store through SleefDFT_setPlanFilePath
+
+static int checkPlanFile(int n) {
+  int success = 1;
+  char path0[256], path1[256];
+
+  remove(fn);
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest0", SLEEF_PLAN_BINARY);
+  if (initPlan(n, path0, sizeof(path0)) || !PlanStore_isPlanStore(fn)) {
+    printf("Saving a plan : NG\n");
+    success = 0;
+  }
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest1", SLEEF_PLAN_BINARY);
+  initPlan(n, path1, sizeof(path1));
+
+  // The format is detected by the magic without SLEEF_PLAN_BINARY
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest0", SLEEF_PLAN_AUTOMATIC);
+  if (!initPlan(n, path1, sizeof(path1)) || strcmp(path0, path1) != 0) {
+    printf("Loading a plan : NG (%s, %s)\n", path0, path1);
+    success = 0;
+  }
+
+  // SLEEF_PLAN_RESET only removes the plans of the architecture
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest0", SLEEF_PLAN_BINARY | SLEEF_PLAN_RESET);
+  if (initPlan(n, path0, sizeof(path0))) {
+    printf("SLEEF_PLAN_RESET : NG\n");
+    success = 0;
+  }
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest1", SLEEF_PLAN_AUTOMATIC);
+  if (!initPlan(n, path1, sizeof(path1))) {
+    printf("Plans of another architecture : NG\n");
+    success = 0;
+  }
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest0", SLEEF_PLAN_AUTOMATIC);
+  if (!initPlan(n, path1, sizeof(path1))) {
+    printf("Plans saved after SLEEF_PLAN_RESET : NG\n");
+    success = 0;
+  }
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  remove(fn);
+
+  return success;
+}
+
+// The cost model of SLEEF_MODE_ESTIMATE is calibrated once for each
+// ISA, and is then loaded from the plan file
+
+static int checkCostModel(int n) {
+  int success = 1;
+
+  remove(fn);
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest0", SLEEF_PLAN_BINARY);
+  if (!initPlanMsg(n, SLEEF_MODE_ESTIMATE, "Cost model : calibrated", NULL, 0)) {
+    printf("Calibration of the cost model : NG\n");
+    success = 0;
+  }
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  SleefDFT_setPlanFilePath(fn, "planstoretest0", SLEEF_PLAN_AUTOMATIC);
+  if (!initPlanMsg(n, SLEEF_MODE_ESTIMATE, "Cost model : loaded", NULL, 0) ||
+      initPlanMsg(n, SLEEF_MODE_ESTIMATE, "Cost model : calibrated", NULL, 0)) {
+    printf("Loading the cost model : NG\n");
+    success = 0;
+  }
+
+  SleefDFT_setPlanFilePath(NULL, NULL, SLEEF_PLAN_RESET);
+  remove(fn);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  sprintf(fn, "planstoretest%d.%d.bin", BASETYPEID, (int)getpid());
+
+  int success = 1;
+
+  success &= checkStore();
+  success &= checkPlanFile(n);
+  success &= checkCostModel(n);
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,133 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// The power, magnitude, power in decibels and phase computed by plans
+// are compared with those computed from the spectrum given by a plan
+// without post-processing.
+
+static double postValue(uint64_t post, double re, double im) {
+  switch(post) {
+  case SLEEF_MODE_POWER: return re * re + im * im;
+  case SLEEF_MODE_MAGNITUDE: return hypot(re, im);
+  case SLEEF_MODE_POWERDB: return 10 * log10(re * re + im * im);
+  default: return atan2(im, re);
+  }
+}
+
+static int check(int n, uint64_t mode, uint64_t post) {
+  int nIn = n * 2, nOut = n * 2, nBin = n;
+  if ((mode & SLEEF_MODE_REAL) != 0) { nIn = n; nOut = n + 2; nBin = n / 2 + 1; }
+
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, MODE | mode | post);
+  struct SleefDFT *q = SleefDFT_init1d(n, NULL, NULL, MODE | mode);
+
+  real *sx = (real *)Sleef_malloc(nIn * sizeof(real));
+  real *sy = (real *)Sleef_malloc(nOut * sizeof(real));
+  real *ty = (real *)Sleef_malloc(nOut * sizeof(real));
+  double *ref = (double *)malloc(nBin * sizeof(double));
+
+  for(int i=0;i<nIn;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+  SleefDFT_execute(p, sx, sy);
+  SleefDFT_execute(q, sx, ty);
+
+  if ((mode & SLEEF_MODE_REAL) != 0 && (mode & SLEEF_MODE_ALT) != 0) {
+    ref[0] = postValue(post, ty[0], 0);
+    for(int k=1;k<n/2;k++) ref[k] = postValue(post, ty[k*2+0], ty[k*2+1]);
+    ref[n/2] = postValue(post, ty[1], 0);
+  } else {
+    for(int k=0;k<nBin;k++) ref[k] = postValue(post, ty[k*2+0], ty[k*2+1]);
+  }
+
+  int success = 1;
+  for(int k=0;k<nBin;k++) {
+    if (!(fabs(sy[k] - ref[k]) <= THRES * (1 + fabs(ref[k])))) success = 0;
+  }
+
+  printf("n=%d mode=%llx post=%llx : %s\n", n, (unsigned long long)mode, (unsigned long long)post, success ? "OK" : "NG");
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+  free(ref);
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(q);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  static const uint64_t modes[] = {
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_COMPLEX,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_COMPLEX,
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_REAL,
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_REAL | SLEEF_MODE_ALT,
+  };
+
+  static const uint64_t posts[] = { SLEEF_MODE_POWER, SLEEF_MODE_MAGNITUDE, SLEEF_MODE_POWERDB, SLEEF_MODE_PHASE };
+
+  for(int i=0;i<4;i++) {
+    for(int j=0;j<4;j++) {
+      success &= check(n, modes[i] | SLEEF_MODE_ESTIMATE, posts[j]);
+      success &= check(n, modes[i] | SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT, posts[j]);
+      success &= check(4, modes[i] | SLEEF_MODE_ESTIMATE, posts[j]);
+      success &= check(16, modes[i] | SLEEF_MODE_ESTIMATE, posts[j]);
+      // The first ISA computes the values without the vector functions
+      success &= check(n, modes[i] | SLEEF_MODE_ESTIMATE | SLEEF_MODE_REPRODUCIBLE, posts[j]);
+    }
+  }
+
+  // The output of real backward transforms cannot be post-processed
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL | SLEEF_MODE_POWER);
+  if (p != NULL) {
+    printf("Real backward transform with SLEEF_MODE_POWER : NG\n");
+    SleefDFT_dispose(p);
+    success = 0;
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
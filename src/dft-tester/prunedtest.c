@@ -0,0 +1,104 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_init1dPruned SleefDFT_double_init1dPruned
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_init1dPruned SleefDFT_float_init1dPruned
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// Compares a pruned transform with the full transform of the zero-padded input
+
+static int check(int n, int nIn, int nOut, uint64_t mode) {
+  real *sx = (real *)Sleef_malloc(n * 2 * sizeof(real));
+  real *sy = (real *)Sleef_malloc(n * 2 * sizeof(real));
+  real *px = (real *)Sleef_malloc(nIn * 2 * sizeof(real));
+  real *py = (real *)Sleef_malloc((nOut + 8) * 2 * sizeof(real));
+
+  memset(sx, 0, n * 2 * sizeof(real));
+  for(int i=0;i<nIn*2;i++) sx[i] = px[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+  for(int i=0;i<(nOut+8)*2;i++) py[i] = 12345;
+
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, mode | SLEEF_MODE_ESTIMATE);
+  struct SleefDFT *q = SleefDFT_init1dPruned(n, nIn, nOut, NULL, NULL, MODE | mode);
+
+  SleefDFT_execute(p, sx, sy);
+  SleefDFT_execute(q, px, py);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<nOut*2;i++) {
+    rmsn += (sy[i] - py[i]) * (double)(sy[i] - py[i]);
+    rmsd += sy[i] * (double)sy[i];
+  }
+
+  int success = sqrt(rmsn / rmsd) < THRES;
+  for(int i=nOut*2;i<(nOut+8)*2;i++) if (py[i] != 12345) success = 0;
+
+  printf("n=%d nIn=%d nOut=%d mode=%llx : %s\n", n, nIn, nOut, (unsigned long long)mode, success ? "OK" : "NG");
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(q);
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(px);
+  Sleef_free(py);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  static const uint64_t modes[] = { SLEEF_MODE_FORWARD, SLEEF_MODE_BACKWARD, SLEEF_MODE_FORWARD | SLEEF_MODE_ALT };
+
+  for(int i=0;i<3;i++) {
+    success &= check(n, n / 8, n, modes[i]);
+    success &= check(n, n, n / 4, modes[i]);
+    success &= check(n, n / 8, n / 2, modes[i]);
+    success &= check(n, n / 4, n / 16, modes[i]);
+    success &= check(n, n, n, modes[i]);
+    success &= check(n, 3, 5, modes[i]);
+    success &= check(n, n / 2 + 1, n - 3, modes[i]);
+  }
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,136 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#include "testerutil.h"
+
+#if BASETYPEID == 1
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define THRES 1e-5
+#endif
+
+// Plans in SLEEF_MODE_REALTIME are compared with plans in the normal
+// mode. Tables are prefetched before every other execution.
+
+static int compare(struct SleefDFT *p, struct SleefDFT *q, int nIn, int nOut, const void *arg) {
+  real *sx = (real *)Sleef_malloc(nIn * sizeof(real));
+  real *sy = (real *)Sleef_malloc(nOut * sizeof(real));
+  real *ty = (real *)Sleef_malloc(nOut * sizeof(real));
+
+  int success = 1;
+
+  for(int iter=0;iter<4;iter++) {
+    for(int i=0;i<nIn;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+
+    if ((iter & 1) == 0) SleefDFT_prefetch(p);
+    SleefDFT_execute(p, sx, sy);
+    SleefDFT_execute(q, sx, ty);
+
+    double rmsn = 0, rmsd = 0;
+    for(int i=0;i<nOut;i++) {
+      rmsn += (sy[i] - ty[i]) * (double)(sy[i] - ty[i]);
+      rmsd += ty[i] * (double)ty[i];
+    }
+
+    if (!(sqrt(rmsn / rmsd) < THRES)) success = 0;
+  }
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+
+  return success;
+}
+
+static int check1dRT(int n, uint64_t mode) {
+  return check1d(n, mode | SLEEF_MODE_REALTIME, MODE | SLEEF_MODE_ESTIMATE | (mode & ~SLEEF_MODE_MEASURE), compare, NULL, "");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int log2n = atoi(argv[1]);
+  const int n = 1 << log2n;
+
+  int success = 1;
+
+#ifdef __linux__
+  cpu_set_t set0, set1;
+  sched_getaffinity(0, sizeof(set0), &set0);
+#endif
+
+#if defined(__linux__) && defined(_OPENMP)
+  const int nThread = omp_get_max_threads();
+  cpu_set_t *workerSet = (cpu_set_t *)calloc(nThread, sizeof(cpu_set_t));
+#pragma omp parallel num_threads(nThread)
+  sched_getaffinity(0, sizeof(cpu_set_t), &workerSet[omp_get_thread_num()]);
+#endif
+
+  for(int i=0;i<4;i++) {
+    success &= check1dRT(n, testModes[i] | SLEEF_MODE_ESTIMATE);
+    success &= check1dRT(n, testModes[i] | SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT);
+  }
+  success &= check1dRT(n, SLEEF_MODE_FORWARD | SLEEF_MODE_MEASURE);
+  success &= check1dRT(n, SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL | SLEEF_MODE_MEASURE | SLEEF_MODE_NO_MT);
+  success &= check2d(1 << (log2n/2), 1 << (log2n - log2n/2), SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE | SLEEF_MODE_REALTIME,
+		     MODE | SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE, compare, NULL, "");
+
+#ifdef __linux__
+  // Only the worker threads are bound to CPUs
+  sched_getaffinity(0, sizeof(set1), &set1);
+  if (!CPU_EQUAL(&set0, &set1)) {
+    printf("The affinity of the calling thread was changed\n");
+    success = 0;
+  }
+#endif
+
+#if defined(__linux__) && defined(_OPENMP)
+  // The worker threads are unbound when the last plan is disposed
+  int restored = 1;
+#pragma omp parallel num_threads(nThread) reduction(&:restored)
+  {
+    cpu_set_t set;
+    sched_getaffinity(0, sizeof(set), &set);
+    restored = CPU_EQUAL(&set, &workerSet[omp_get_thread_num()]);
+  }
+  if (!restored) {
+    printf("The affinity of the worker threads was not restored\n");
+    success = 0;
+  }
+  free(workerSet);
+#endif
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
@@ -0,0 +1,204 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE 0
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_init2d SleefDFT_double_init2d
+#define SleefDFT_init1dBatch SleefDFT_double_init1dBatch
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_init2d SleefDFT_float_init2d
+#define SleefDFT_init1dBatch SleefDFT_float_init1dBatch
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// Plans in SLEEF_MODE_REPRODUCIBLE have to give bitwise identical
+// results regardless of the number of threads, the planning effort and
+// SLEEF_MODE_DEBUG. They are also compared with plans in the normal
+// mode for accuracy.
+
+static void setNumThreads(int n) {
+#ifdef _OPENMP
+  omp_set_num_threads(n);
+#endif
+}
+
+static real *randomBuf(int n) {
+  real *b = (real *)Sleef_malloc(n * sizeof(real));
+  for(int i=0;i<n;i++) b[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+  return b;
+}
+
+static int check1d(int n, uint64_t mode) {
+  int nIn = n * 2, nOut = n * 2;
+  if ((mode & SLEEF_MODE_REAL) != 0) {
+    if ((mode & SLEEF_MODE_BACKWARD) == 0) { nIn = n; nOut = n + 2; } else { nIn = n + 2; nOut = n; }
+  }
+
+  real *sx = randomBuf(nIn);
+  real *ry = (real *)Sleef_malloc(nOut * sizeof(real));
+  real *ty = (real *)Sleef_malloc(nOut * sizeof(real));
+
+  int success = 1;
+
+  setNumThreads(1);
+  struct SleefDFT *r = SleefDFT_init1d(n, NULL, NULL, MODE | mode | SLEEF_MODE_REPRODUCIBLE | SLEEF_MODE_NO_MT);
+  SleefDFT_execute(r, sx, ry);
+  SleefDFT_dispose(r);
+
+  static const uint64_t variants[] = {
+    SLEEF_MODE_ESTIMATE, SLEEF_MODE_MEASURE, SLEEF_MODE_DEBUG, SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT,
+  };
+
+  for(int nth=1;nth<=4;nth++) {
+    for(int v=0;v<4;v++) {
+      setNumThreads(nth);
+      struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, MODE | mode | SLEEF_MODE_REPRODUCIBLE | variants[v]);
+      memset(ty, 0, nOut * sizeof(real));
+      SleefDFT_execute(p, sx, ty);
+      SleefDFT_dispose(p);
+      if (memcmp(ry, ty, nOut * sizeof(real)) != 0) success = 0;
+    }
+  }
+
+  setNumThreads(4);
+  struct SleefDFT *q = SleefDFT_init1d(n, NULL, NULL, MODE | mode | SLEEF_MODE_ESTIMATE);
+  SleefDFT_execute(q, sx, ty);
+  SleefDFT_dispose(q);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<nOut;i++) {
+    rmsn += (ry[i] - ty[i]) * (double)(ry[i] - ty[i]);
+    rmsd += ty[i] * (double)ty[i];
+  }
+  if (!(sqrt(rmsn / rmsd) < THRES)) success = 0;
+
+  printf("1D n=%d mode=%llx : %s\n", n, (unsigned long long)mode, success ? "OK" : "NG");
+
+  Sleef_free(sx);
+  Sleef_free(ry);
+  Sleef_free(ty);
+
+  return success;
+}
+
+static int check2d(int n, int m) {
+  real *sx = randomBuf(n*m*2);
+  real *ry = (real *)Sleef_malloc(n*m*2 * sizeof(real));
+  real *ty = (real *)Sleef_malloc(n*m*2 * sizeof(real));
+
+  setNumThreads(1);
+  struct SleefDFT *r = SleefDFT_init2d(n, m, NULL, NULL, MODE | SLEEF_MODE_REPRODUCIBLE | SLEEF_MODE_NO_MT);
+  SleefDFT_execute(r, sx, ry);
+  SleefDFT_dispose(r);
+
+  setNumThreads(3);
+  struct SleefDFT *p = SleefDFT_init2d(n, m, NULL, NULL, MODE | SLEEF_MODE_REPRODUCIBLE | SLEEF_MODE_DEBUG);
+
+  int success = 1;
+  for(int iter=0;iter<4;iter++) {
+    memset(ty, 0, n*m*2 * sizeof(real));
+    SleefDFT_execute(p, sx, ty);
+    if (memcmp(ry, ty, n*m*2 * sizeof(real)) != 0) success = 0;
+  }
+  SleefDFT_dispose(p);
+
+  printf("2D n=%d m=%d : %s\n", n, m, success ? "OK" : "NG");
+
+  Sleef_free(sx);
+  Sleef_free(ry);
+  Sleef_free(ty);
+
+  return success;
+}
+
+// Each transform in a batch has to be identical to a single transform
+
+static int checkBatch(int n, int batch) {
+  real *sx = randomBuf(n * batch);
+  real *ry = (real *)Sleef_malloc((n+2) * sizeof(real));
+  real *ty = (real *)Sleef_malloc((n+2) * batch * sizeof(real));
+
+  setNumThreads(1);
+  struct SleefDFT *r = SleefDFT_init1d(n, NULL, NULL, MODE | SLEEF_MODE_REAL | SLEEF_MODE_REPRODUCIBLE | SLEEF_MODE_NO_MT);
+
+  setNumThreads(2);
+  struct SleefDFT *p = SleefDFT_init1dBatch(n, batch, NULL, NULL, MODE | SLEEF_MODE_REAL | SLEEF_MODE_REPRODUCIBLE | SLEEF_MODE_MEASURE);
+  SleefDFT_execute(p, sx, ty);
+
+  int success = 1;
+  for(int c=0;c<batch;c++) {
+    SleefDFT_execute(r, sx + c * n, ry);
+    if (memcmp(ry, ty + c * (n+2), (n+2) * sizeof(real)) != 0) success = 0;
+  }
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(r);
+
+  printf("Batch n=%d batch=%d : %s\n", n, batch, success ? "OK" : "NG");
+
+  Sleef_free(sx);
+  Sleef_free(ry);
+  Sleef_free(ty);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int log2n = atoi(argv[1]);
+
+  int success = 1;
+
+  static const uint64_t modes[] = {
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_COMPLEX,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_COMPLEX,
+    SLEEF_MODE_FORWARD  | SLEEF_MODE_REAL,
+    SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL,
+  };
+
+  for(int i=0;i<4;i++) {
+    success &= check1d(1 << log2n, modes[i]);
+    success &= check1d(1 << (log2n + 5), modes[i]);
+  }
+  success &= check2d(1 << (log2n/2), 1 << (log2n - log2n/2));
+  success &= checkBatch(1 << log2n, 5);
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
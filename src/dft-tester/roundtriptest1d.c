@@ -13,6 +13,11 @@
 #include <complex.h>
 
 #include "sleef.h"
+
+#if BASETYPEID == 4
+#include "quaddef.h"
+#endif
+
 #include "sleefdft.h"
 
 #ifndef MODE
@@ -24,16 +29,30 @@
 #define SleefDFT_init SleefDFT_double_init1d
 #define SleefDFT_execute SleefDFT_double_execute
 typedef double real;
+typedef double ereal;
 #elif BASETYPEID == 2
 #define THRES 1e-13
 #define SleefDFT_init SleefDFT_float_init1d
 #define SleefDFT_execute SleefDFT_float_execute
 typedef float real;
+typedef double ereal;
+#elif BASETYPEID == 3
+#define THRES 1e-35
+#define SleefDFT_init SleefDFT_longdouble_init1d
+#define SleefDFT_execute SleefDFT_longdouble_execute
+typedef long double real;
+typedef long double ereal;
+#elif BASETYPEID == 4
+#define THRES 1e-63
+#define SleefDFT_init SleefDFT_quad_init1d
+#define SleefDFT_execute SleefDFT_quad_execute
+typedef Sleef_quad real;
+typedef Sleef_quad ereal;
 #else
 #error BASETYPEID not set
 #endif
 
-static double squ(double x) { return x * x; }
+static ereal squ(ereal x) { return x * x; }
 
 // complex transforms
 double check_c(int n) {
@@ -71,7 +90,7 @@ double check_c(int n) {
 
   //
 
-  double rmsn = 0, rmsd = 0, scale = 1 / (double)n;
+  ereal rmsn = 0, rmsd = 0, scale = 1 / (ereal)n;
   
   for(int i=0;i<n;i++) {
     rmsn += squ(scale * sz[i*2+0] - sx[i*2+0]) + squ(scale * sz[i*2+1] - sx[i*2+1]);
@@ -86,7 +105,7 @@ double check_c(int n) {
 
   //
 
-  return rmsn / rmsd;
+  return (double)(rmsn / rmsd);
 }
 
 // real transforms
@@ -125,7 +144,7 @@ double check_r(int n) {
 
   //
 
-  double rmsn = 0, rmsd = 0, scale = 1 / (double)n;
+  ereal rmsn = 0, rmsd = 0, scale = 1 / (ereal)n;
   
   for(int i=0;i<n;i++) {
     rmsn += squ(scale * sz[i] - sx[i]);
@@ -140,7 +159,7 @@ double check_r(int n) {
 
   //
 
-  return rmsn / rmsd;
+  return (double)(rmsn / rmsd);
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,136 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_execute SleefDFT_double_execute
+#define SleefDFT_executeStream SleefDFT_double_executeStream
+typedef double real;
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_execute SleefDFT_float_execute
+#define SleefDFT_executeStream SleefDFT_float_executeStream
+typedef float real;
+#define THRES 1e-5
+#else
+#error BASETYPEID not set
+#endif
+
+// Blocks are streamed from and to memory through the callbacks, and
+// the results are compared with executing the plan on each block. The
+// reader ends the stream after a given number of blocks, and the
+// writer checks that the blocks are written in order.
+
+typedef struct {
+  const char *src;
+  char *dst;
+  uint64_t srcSize, nextWrite;
+  int64_t failWriteAt;
+  int outOfOrder;
+} stream_t;
+
+static int readBlock(void *ctx, int target, uint64_t offset, void *buf, uint64_t size) {
+  stream_t *st = (stream_t *)ctx;
+  if (target != SLEEF_OOC_INPUT || offset + size > st->srcSize) return 1;
+  memcpy(buf, st->src + offset, size);
+  return 0;
+}
+
+static int writeBlock(void *ctx, uint64_t offset, const void *buf, uint64_t size) {
+  stream_t *st = (stream_t *)ctx;
+  if (st->failWriteAt >= 0 && offset >= (uint64_t)st->failWriteAt) return 1;
+  if (offset != st->nextWrite) st->outOfOrder = 1;
+  st->nextWrite = offset + size;
+  memcpy(st->dst + offset, buf, size);
+  return 0;
+}
+
+static int check(int n, uint64_t mode, int nAvail, uint64_t nBlocks, int failAt) {
+  int nIn = n * 2, nOut = n * 2;
+  if ((mode & SLEEF_MODE_REAL) != 0) {
+    if ((mode & SLEEF_MODE_BACKWARD) == 0) { nIn = n; nOut = n + 2; } else { nIn = n + 2; nOut = n; }
+  }
+
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, MODE | mode);
+
+  real *sx = (real *)Sleef_malloc(sizeof(real) * nIn * nAvail);
+  real *sy = (real *)Sleef_malloc(sizeof(real) * nOut * nAvail);
+  real *ty = (real *)Sleef_malloc(sizeof(real) * nOut);
+
+  for(int i=0;i<nIn * nAvail;i++) sx[i] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+  memset(sy, 0, sizeof(real) * nOut * nAvail);
+
+  stream_t st = { (const char *)sx, (char *)sy, sizeof(real) * nIn * nAvail, 0, failAt < 0 ? -1 : (int64_t)(sizeof(real) * nOut * failAt), 0 };
+
+  int64_t ret = SleefDFT_executeStream(p, nBlocks, readBlock, writeBlock, &st);
+
+  int64_t expected = nBlocks != 0 && nBlocks < (uint64_t)nAvail ? (int64_t)nBlocks : nAvail;
+  if (failAt >= 0 && failAt < expected) expected = -1;
+
+  int success = ret == expected && !st.outOfOrder;
+
+  for(int b=0;b<(ret < 0 ? failAt : ret) && success;b++) {
+    SleefDFT_execute(p, sx + (size_t)b * nIn, ty);
+
+    double rmsn = 0, rmsd = 0;
+    for(int i=0;i<nOut;i++) {
+      real y = sy[(size_t)b * nOut + i];
+      rmsn += (y - ty[i]) * (double)(y - ty[i]);
+      rmsd += ty[i] * (double)ty[i];
+    }
+    if (!(sqrt(rmsn / rmsd) < THRES)) success = 0;
+  }
+
+  printf("n=%d mode=%llx available=%d nBlocks=%llu failAt=%d : %lld blocks, %s\n", n, (unsigned long long)mode,
+	 nAvail, (unsigned long long)nBlocks, failAt, (long long)ret, success ? "OK" : "NG");
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ty);
+
+  SleefDFT_dispose(p);
+
+  return success;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int n = 1 << atoi(argv[1]);
+
+  int success = 1;
+
+  success &= check(n, SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE, 37, 0, -1);
+  success &= check(n, SLEEF_MODE_BACKWARD | SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT, 37, 0, -1);
+  success &= check(n, SLEEF_MODE_FORWARD | SLEEF_MODE_REAL | SLEEF_MODE_ESTIMATE, 37, 20, -1);
+  success &= check(n, SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL | SLEEF_MODE_ESTIMATE, 1, 0, -1);
+  success &= check(n, SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE, 37, 0, 11);
+  success &= check(4, SLEEF_MODE_FORWARD | SLEEF_MODE_REAL | SLEEF_MODE_ESTIMATE, 9, 0, -1);
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
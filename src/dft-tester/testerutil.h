@@ -0,0 +1,68 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Checks a plan against a reference plan of the same size. The
+// including file defines MODE, and a comparison function that
+// executes both plans on nIn input and nOut output elements.
+
+#if BASETYPEID == 1
+#define SleefDFT_init1d SleefDFT_double_init1d
+#define SleefDFT_init2d SleefDFT_double_init2d
+#define SleefDFT_execute SleefDFT_double_execute
+typedef double real;
+#elif BASETYPEID == 2
+#define SleefDFT_init1d SleefDFT_float_init1d
+#define SleefDFT_init2d SleefDFT_float_init2d
+#define SleefDFT_execute SleefDFT_float_execute
+typedef float real;
+#else
+#error BASETYPEID not set
+#endif
+
+typedef int (*compare_t)(struct SleefDFT *p, struct SleefDFT *ref, int nIn, int nOut, const void *arg);
+
+// The directions and the types of 1D transforms
+
+static const uint64_t testModes[] = {
+  SLEEF_MODE_FORWARD  | SLEEF_MODE_COMPLEX,
+  SLEEF_MODE_BACKWARD | SLEEF_MODE_COMPLEX,
+  SLEEF_MODE_FORWARD  | SLEEF_MODE_REAL,
+  SLEEF_MODE_BACKWARD | SLEEF_MODE_REAL,
+};
+
+// The plan is initialized with MODE | mode, and the reference plan
+// with refMode. tag is printed after the mode.
+
+static int check1d(int n, uint64_t mode, uint64_t refMode, compare_t compare, const void *arg, const char *tag) {
+  int nIn = n * 2, nOut = n * 2;
+  if ((mode & SLEEF_MODE_REAL) != 0) {
+    if ((mode & SLEEF_MODE_BACKWARD) == 0) { nIn = n; nOut = n + 2; } else { nIn = n + 2; nOut = n; }
+    if ((mode & SLEEF_MODE_ALT) != 0) nIn = nOut = n;
+  }
+
+  struct SleefDFT *p = SleefDFT_init1d(n, NULL, NULL, MODE | mode);
+  struct SleefDFT *ref = SleefDFT_init1d(n, NULL, NULL, refMode);
+
+  int success = compare(p, ref, nIn, nOut, arg);
+  printf("1D n=%d mode=%llx %s : %s\n", n, (unsigned long long)mode, tag, success ? "OK" : "NG");
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(ref);
+
+  return success;
+}
+
+static int check2d(int n, int m, uint64_t mode, uint64_t refMode, compare_t compare, const void *arg, const char *tag) {
+  struct SleefDFT *p = SleefDFT_init2d(n, m, NULL, NULL, MODE | mode);
+  struct SleefDFT *ref = SleefDFT_init2d(n, m, NULL, NULL, refMode);
+
+  int success = compare(p, ref, n*m*2, n*m*2, arg);
+  printf("2D n=%d m=%d mode=%llx %s : %s\n", n, m, (unsigned long long)mode, tag, success ? "OK" : "NG");
+
+  SleefDFT_dispose(p);
+  SleefDFT_dispose(ref);
+
+  return success;
+}
@@ -0,0 +1,113 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "sleef.h"
+#include "sleefdft.h"
+
+#ifndef MODE
+#define MODE SLEEF_MODE_VERBOSE
+#endif
+
+#include "testerutil.h"
+
+#if BASETYPEID == 1
+#define THRES 1e-12
+#elif BASETYPEID == 2
+#define THRES 1e-4
+#endif
+
+// Executes the reference plan on aligned buffers and the plan on
+// buffers displaced by ofs[0] and ofs[1] real elements, and compares
+// the results
+
+static int compare(struct SleefDFT *p, struct SleefDFT *ref, int nIn, int nOut, const void *arg) {
+  const int ofsIn = ((const int *)arg)[0], ofsOut = ((const int *)arg)[1];
+  real *sx = (real *)Sleef_malloc((nIn + 64) * sizeof(real));
+  real *sy = (real *)Sleef_malloc((nOut + 64) * sizeof(real));
+  real *ux = (real *)Sleef_malloc((nIn + 64) * sizeof(real));
+  real *uy = (real *)Sleef_malloc((nOut + 64) * sizeof(real));
+
+  for(int i=0;i<nIn;i++) sx[i] = ux[i+ofsIn] = (real)(2.0 * (rand() / (double)RAND_MAX) - 1);
+  for(int i=0;i<nOut+64;i++) uy[i] = 12345;
+
+  SleefDFT_execute(ref, sx, sy);
+  SleefDFT_execute(p, ux + ofsIn, uy + ofsOut);
+
+  double rmsn = 0, rmsd = 0;
+  for(int i=0;i<nOut;i++) {
+    rmsn += (sy[i] - uy[i+ofsOut]) * (sy[i] - uy[i+ofsOut]);
+    rmsd += sy[i] * sy[i];
+  }
+
+  int success = sqrt(rmsn / rmsd) < THRES;
+
+  // Elements outside the output region must not be touched
+
+  for(int i=0;i<ofsOut;i++) if (uy[i] != 12345) success = 0;
+  for(int i=nOut+ofsOut;i<nOut+64;i++) if (uy[i] != 12345) success = 0;
+
+  Sleef_free(sx);
+  Sleef_free(sy);
+  Sleef_free(ux);
+  Sleef_free(uy);
+
+  return success;
+}
+
+// The reference plan is estimated for aligned buffers
+
+static int check1dOfs(int n, uint64_t mode, const int *ofs) {
+  char tag[32];
+  snprintf(tag, sizeof(tag), "ofs=%d/%d", ofs[0], ofs[1]);
+  return check1d(n, mode, (mode & 3) | SLEEF_MODE_ESTIMATE, compare, ofs, tag);
+}
+
+static int check2dOfs(int n, int m, uint64_t mode, const int *ofs) {
+  char tag[32];
+  snprintf(tag, sizeof(tag), "ofs=%d/%d", ofs[0], ofs[1]);
+  return check2d(n, m, mode, (mode & 3) | SLEEF_MODE_ESTIMATE, compare, ofs, tag);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "%s <log2n>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int log2n = atoi(argv[1]);
+  const int n = 1 << log2n;
+
+  int success = 1;
+
+  // An offset of 2 displaces by one complex element, and an odd
+  // offset breaks the alignment of real input and output
+
+  static const int offsets[][2] = { { 0, 2 }, { 2, 0 }, { 2, 2 }, { 1, 3 } }, offsets2d[][2] = { { 2, 2 }, { 2, 0 } };
+
+  for(int i=0;i<4;i++) {
+    for(int j=0;j<4;j++) {
+      if ((testModes[i] & SLEEF_MODE_REAL) == 0 && (offsets[j][0] & 1) != 0) continue;
+      success &= check1dOfs(n, testModes[i] | SLEEF_MODE_ESTIMATE, offsets[j]);
+      success &= check1dOfs(n, testModes[i] | SLEEF_MODE_MEASURE | SLEEF_MODE_UNALIGNED, offsets[j]);
+    }
+  }
+
+  success &= check2dOfs(1 << (log2n/2), 1 << (log2n - log2n/2), SLEEF_MODE_FORWARD | SLEEF_MODE_ESTIMATE, offsets2d[0]);
+  success &= check2dOfs(1 << (log2n/2), 1 << (log2n - log2n/2), SLEEF_MODE_BACKWARD | SLEEF_MODE_MEASURE | SLEEF_MODE_UNALIGNED, offsets2d[1]);
+
+  if (success) {
+    printf("OK\n");
+    exit(0);
+  }
+
+  printf("NG\n");
+  exit(-1);
+}
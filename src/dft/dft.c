@@ -18,8 +18,13 @@
 #include "misc.h"
 #include "common.h"
 #include "arraymap.h"
+#include "cyclecounter.h"
 #include "dftcommon.h"
 
+#if BASETYPEID == 4
+#include "quaddef.h"
+#endif
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -32,7 +37,23 @@ typedef Sleef_double2 sc_t;
 #define MAGIC2D 0x17320508
 #define INIT SleefDFT_double_init1d
 #define EXECUTE SleefDFT_double_execute
+#define EXECUTEINT SleefDFT_double_executeInt
+#define EXECUTESTREAM SleefDFT_double_executeStream
 #define INIT2D SleefDFT_double_init2d
+#define MAGICOOC 0x14142135
+#define MAGICPRUNED 0x47712125
+#define INITPRUNED SleefDFT_double_init1dPruned
+#define MAGICBATCH 0x16487212
+#define INITBATCH SleefDFT_double_init1dBatch
+#define MAGIC2DBATCH 0x26180339
+#define INIT2DBATCH SleefDFT_double_init2dBatch
+#define MAGICGRAPH 0x69897000
+#define INITGRAPH SleefDFT_double_initGraph
+#define ADDTRANSFORM SleefDFT_double_addTransform
+#define ADDCALLBACK SleefDFT_double_addCallback
+#define INITOOC SleefDFT_double_init1dOutOfCore
+#define EXECUTEOOC SleefDFT_double_executeOutOfCore
+#define EXECUTEFILE SleefDFT_double_executeFile
 #define CTBL ctbl_double
 #define REALSUB0 realSub0_double
 #define REALSUB1 realSub1_double
@@ -44,8 +65,25 @@ typedef Sleef_double2 sc_t;
 #define TBUTB tbutb_double
 #define BUTF butf_double
 #define BUTB butb_double
+#define DFTFU dftfu_double
+#define DFTBU dftbu_double
+#define TBUTFU tbutfu_double
+#define TBUTBU tbutbu_double
+#define REALSUB0U realSub0u_double
+#define REALSUB1U realSub1u_double
+#define DFTFX dftfx_double
+#define DFTBX dftbx_double
+#define TBUTFX tbutfx_double
+#define TBUTBX tbutbx_double
+#define REALSUB0X realSub0x_double
+#define REALSUB1X realSub1x_double
+#define POSTINPLACEX postInPlacex_double
 #define SINCOSPI Sleef_sincospi_u05
+#define HYPOT Sleef_hypot_u35
+#define LOG10 Sleef_log10_u10
+#define ATAN2 Sleef_atan2_u35
 #include "dispatchdp.h"
+#define REALC(x) x ## L
 #elif BASETYPEID == 2
 typedef float real;
 typedef Sleef_float2 sc_t;
@@ -54,7 +92,24 @@ typedef Sleef_float2 sc_t;
 #define MAGIC2D 0x22360679
 #define INIT SleefDFT_float_init1d
 #define EXECUTE SleefDFT_float_execute
+#define EXECUTE16 SleefDFT_float_execute16
+#define EXECUTEINT SleefDFT_float_executeInt
+#define EXECUTESTREAM SleefDFT_float_executeStream
 #define INIT2D SleefDFT_float_init2d
+#define MAGICOOC 0x16180339
+#define MAGICPRUNED 0x30102999
+#define INITPRUNED SleefDFT_float_init1dPruned
+#define MAGICBATCH 0x44721359
+#define INITBATCH SleefDFT_float_init1dBatch
+#define MAGIC2DBATCH 0x17724538
+#define INIT2DBATCH SleefDFT_float_init2dBatch
+#define MAGICGRAPH 0x84509804
+#define INITGRAPH SleefDFT_float_initGraph
+#define ADDTRANSFORM SleefDFT_float_addTransform
+#define ADDCALLBACK SleefDFT_float_addCallback
+#define INITOOC SleefDFT_float_init1dOutOfCore
+#define EXECUTEOOC SleefDFT_float_executeOutOfCore
+#define EXECUTEFILE SleefDFT_float_executeFile
 #define CTBL ctbl_float
 #define REALSUB0 realSub0_float
 #define REALSUB1 realSub1_float
@@ -66,8 +121,83 @@ typedef Sleef_float2 sc_t;
 #define TBUTB tbutb_float
 #define BUTF butf_float
 #define BUTB butb_float
+#define DFTFU dftfu_float
+#define DFTBU dftbu_float
+#define TBUTFU tbutfu_float
+#define TBUTBU tbutbu_float
+#define REALSUB0U realSub0u_float
+#define REALSUB1U realSub1u_float
+#define DFTFX dftfx_float
+#define DFTBX dftbx_float
+#define TBUTFX tbutfx_float
+#define TBUTBX tbutbx_float
+#define REALSUB0X realSub0x_float
+#define REALSUB1X realSub1x_float
+#define POSTINPLACEX postInPlacex_float
 #define SINCOSPI Sleef_sincospif_u05
+#define HYPOT Sleef_hypotf_u35
+#define LOG10 Sleef_log10f_u10
+#define ATAN2 Sleef_atan2f_u35
 #include "dispatchsp.h"
+#define REALC(x) x ## L
+#elif BASETYPEID == 3
+typedef long double real;
+typedef struct { real x, y; } sc_t;
+#define BASETYPESTRING "long double"
+#define MAGIC 0x69314718
+#define MAGIC2D 0x26457513
+#define INIT SleefDFT_longdouble_init1d
+#define EXECUTE SleefDFT_longdouble_execute
+#define INIT2D SleefDFT_longdouble_init2d
+#define CTBL ctbl_longdouble
+#define REALSUB0 realSub0_longdouble
+#define REALSUB1 realSub1_longdouble
+#define GETINT getInt_longdouble
+#define GETPTR getPtr_longdouble
+#define DFTF dftf_longdouble
+#define DFTB dftb_longdouble
+#define TBUTF tbutf_longdouble
+#define TBUTB tbutb_longdouble
+#define BUTF butf_longdouble
+#define BUTB butb_longdouble
+#define DFTFU dftfu_longdouble
+#define DFTBU dftbu_longdouble
+#define TBUTFU tbutfu_longdouble
+#define TBUTBU tbutbu_longdouble
+#define REALSUB0U realSub0u_longdouble
+#define REALSUB1U realSub1u_longdouble
+#define SINCOSPI sincospiExt
+#define REALC(x) x ## L
+#include "dispatchld.h"
+#elif BASETYPEID == 4
+typedef Sleef_quad real;
+typedef struct { real x, y; } sc_t;
+#define BASETYPESTRING "quad"
+#define MAGIC 0x57721566
+#define MAGIC2D 0x24494897
+#define INIT SleefDFT_quad_init1d
+#define EXECUTE SleefDFT_quad_execute
+#define INIT2D SleefDFT_quad_init2d
+#define CTBL ctbl_quad
+#define REALSUB0 realSub0_quad
+#define REALSUB1 realSub1_quad
+#define GETINT getInt_quad
+#define GETPTR getPtr_quad
+#define DFTF dftf_quad
+#define DFTB dftb_quad
+#define TBUTF tbutf_quad
+#define TBUTB tbutb_quad
+#define BUTF butf_quad
+#define BUTB butb_quad
+#define DFTFU dftfu_quad
+#define DFTBU dftbu_quad
+#define TBUTFU tbutfu_quad
+#define TBUTBU tbutbu_quad
+#define REALSUB0U realSub0u_quad
+#define REALSUB1U realSub1u_quad
+#define SINCOSPI sincospiExt
+#define REALC(x) SLEEF_QUAD_C(x)
+#include "dispatchqp.h"
 #else
 #error No BASETYPEID specified
 #endif
@@ -75,45 +205,47 @@ typedef Sleef_float2 sc_t;
 #define IMPORT_IS_EXPORT
 #include "sleefdft.h"
 
+#include "dftconv.h"
+
 //
 
 real CTBL[] = {
-  0.7071067811865475243818940365159164684883L, -0.7071067811865475243818940365159164684883L,
-  0.9238795325112867561014214079495587839119L, -0.382683432365089771723257530688933059082L,
-  0.382683432365089771723257530688933059082L, -0.9238795325112867561014214079495587839119L,
+  REALC(0.7071067811865475244008443621048490392848), -REALC(0.7071067811865475244008443621048490392848),
+  REALC(0.9238795325112867561281831893967882868224), -REALC(0.3826834323650897717284599840303988667613),
+  REALC(0.3826834323650897717284599840303988667613), -REALC(0.9238795325112867561281831893967882868224),
 #if MAXBUTWIDTH >= 5
-  0.9807852804032304491190993878113602022495L, -0.1950903220161282678433729148581576851029L,
-  0.5555702330196022247573058028269343822103L, -0.8314696123025452370808655033762590846891L,
-  0.8314696123025452370808655033762590846891L, -0.5555702330196022247573058028269343822103L,
-  0.1950903220161282678433729148581576851029L, -0.9807852804032304491190993878113602022495L,
+  REALC(0.9807852804032304491261822361342390369739), -REALC(0.1950903220161282678482848684770222409277),
+  REALC(0.5555702330196022247428308139485328743749), -REALC(0.8314696123025452370787883776179057567386),
+  REALC(0.8314696123025452370787883776179057567386), -REALC(0.5555702330196022247428308139485328743749),
+  REALC(0.1950903220161282678482848684770222409277), -REALC(0.9807852804032304491261822361342390369739),
 #endif
 #if MAXBUTWIDTH >= 6
-  0.9951847266721968862310254699821143731242L, -0.09801714032956060199569840382660679267701L,
-  0.6343932841636454982026105398063009488396L, -0.7730104533627369607965383602188325085081L,
-  0.881921264348355029715105513066220055407L, -0.4713967368259976485449225247492677226546L,
-  0.2902846772544623676448431737195932100803L, -0.9569403357322088649310892760624369657307L,
-  0.9569403357322088649310892760624369657307L, -0.2902846772544623676448431737195932100803L,
-  0.4713967368259976485449225247492677226546L, -0.881921264348355029715105513066220055407L,
-  0.7730104533627369607965383602188325085081L, -0.6343932841636454982026105398063009488396L,
-  0.09801714032956060199569840382660679267701L, -0.9951847266721968862310254699821143731242L,
+  REALC(0.9951847266721968862448369531094799215755), -REALC(0.09801714032956060199419556388864184586114),
+  REALC(0.6343932841636454982151716132254933706757), -REALC(0.7730104533627369608109066097584698009710),
+  REALC(0.8819212643483550297127568636603883495084), -REALC(0.4713967368259976485563876259052543776575),
+  REALC(0.2902846772544623676361923758173952746915), -REALC(0.9569403357322088649357978869802699694828),
+  REALC(0.9569403357322088649357978869802699694828), -REALC(0.2902846772544623676361923758173952746915),
+  REALC(0.4713967368259976485563876259052543776575), -REALC(0.8819212643483550297127568636603883495084),
+  REALC(0.7730104533627369608109066097584698009710), -REALC(0.6343932841636454982151716132254933706757),
+  REALC(0.09801714032956060199419556388864184586114), -REALC(0.9951847266721968862448369531094799215755),
 #endif
 #if MAXBUTWIDTH >= 7
-  0.9987954562051723927007702841240899260811L, -0.04906767432741801425355085940205324135377L,
-  0.6715589548470184006194634573905233310143L, -0.7409511253549590911932944126139233276263L,
-  0.9039892931234433315823215138173907234886L, -0.427555093430282094315230886905077056781L,
-  0.336889853392220050702686798271834334173L, -0.9415440651830207783906830087961026265475L,
-  0.9700312531945439926159106824865574481009L, -0.2429801799032638899447731489766866275204L,
-  0.5141027441932217266072797923204262815489L, -0.8577286100002720698929313536407192941624L,
-  0.8032075314806449097991200569701675249235L, -0.5956993044924333434615715265891822127742L,
-  0.1467304744553617516588479505190711904561L, -0.9891765099647809734561415551112872890371L,
-  0.9891765099647809734561415551112872890371L, -0.1467304744553617516588479505190711904561L,
-  0.5956993044924333434615715265891822127742L, -0.8032075314806449097991200569701675249235L,
-  0.8577286100002720698929313536407192941624L, -0.5141027441932217266072797923204262815489L,
-  0.2429801799032638899447731489766866275204L, -0.9700312531945439926159106824865574481009L,
-  0.9415440651830207783906830087961026265475L, -0.336889853392220050702686798271834334173L,
-  0.427555093430282094315230886905077056781L, -0.9039892931234433315823215138173907234886L,
-  0.7409511253549590911932944126139233276263L, -0.6715589548470184006194634573905233310143L,
-  0.04906767432741801425355085940205324135377L, -0.9987954562051723927007702841240899260811L,
+  REALC(0.9987954562051723927147716047591006944432), -REALC(0.04906767432741801425495497694268265831475),
+  REALC(0.6715589548470184006253768504274218032288), -REALC(0.7409511253549590911756168974951627297290),
+  REALC(0.9039892931234433315862002972305370487101), -REALC(0.4275550934302820943209668568887985343046),
+  REALC(0.3368898533922200506892532126191475704778), -REALC(0.9415440651830207784125094025995023571856),
+  REALC(0.9700312531945439926039842072861002514569), -REALC(0.2429801799032638899482741620774711183210),
+  REALC(0.5141027441932217265936938389688157726080), -REALC(0.8577286100002720699022699842847701370425),
+  REALC(0.8032075314806449098066765129631419238796), -REALC(0.5956993044924333434670365288299698895119),
+  REALC(0.1467304744553617516588501296467178197062), -REALC(0.9891765099647809734516737380162430639837),
+  REALC(0.9891765099647809734516737380162430639837), -REALC(0.1467304744553617516588501296467178197062),
+  REALC(0.5956993044924333434670365288299698895119), -REALC(0.8032075314806449098066765129631419238796),
+  REALC(0.8577286100002720699022699842847701370425), -REALC(0.5141027441932217265936938389688157726080),
+  REALC(0.2429801799032638899482741620774711183210), -REALC(0.9700312531945439926039842072861002514569),
+  REALC(0.9415440651830207784125094025995023571856), -REALC(0.3368898533922200506892532126191475704778),
+  REALC(0.4275550934302820943209668568887985343046), -REALC(0.9039892931234433315862002972305370487101),
+  REALC(0.7409511253549590911756168974951627297290), -REALC(0.6715589548470184006253768504274218032288),
+  REALC(0.04906767432741801425495497694268265831475), -REALC(0.9987954562051723927147716047591006944432),
 #endif
 };
 
@@ -182,26 +314,30 @@ static void startAllThreads(const int nth) {
 
 // Dispatcher
 
-static void dispatch(SleefDFT *p, const int N, real *d, const real *s, const int level, const int config) {
+// Only the kernels for the first and the last stages have variants
+// for buffers that are not aligned to vectors. Middle stages always
+// operate on internal buffers.
+static void dispatch(SleefDFT *p, const int N, real *d, const real *s, const int level, const int config, const int unaligned) {
   const int K = constK[N], log2len = p->log2len;
   if (level == N) {
     if ((p->mode & SLEEF_MODE_BACKWARD) == 0) {
-      void (*func)(real *, const real *, const int) = DFTF[config][p->isa][N];
+      void (*func)(real *, const real *, const int) = (unaligned ? DFTFU : DFTF)[config][p->isa][N];
       (*func)(d, s, log2len-N);
     } else {
-      void (*func)(real *, const real *, const int) = DFTB[config][p->isa][N];
+      void (*func)(real *, const real *, const int) = (unaligned ? DFTBU : DFTB)[config][p->isa][N];
       (*func)(d, s, log2len-N);
     }
   } else if (level == log2len) {
     assert(p->vecwidth <= (1 << N));
     if ((p->mode & SLEEF_MODE_BACKWARD) == 0) {
-      void (*func)(real *, uint32_t *, const real *, const int, const real *, const int) = TBUTF[config][p->isa][N];
+      void (*func)(real *, uint32_t *, const real *, const int, const real *, const int) = (unaligned ? TBUTFU : TBUTF)[config][p->isa][N];
       (*func)(d, p->perm[level], s, log2len-N, p->tbl[N][level], K);
     } else {
-      void (*func)(real *, uint32_t *, const real *, const int, const real *, const int) = TBUTB[config][p->isa][N];
+      void (*func)(real *, uint32_t *, const real *, const int, const real *, const int) = (unaligned ? TBUTBU : TBUTB)[config][p->isa][N];
       (*func)(d, p->perm[level], s, log2len-N, p->tbl[N][level], K);
     }
   } else {
+    assert(!unaligned);
     if ((p->mode & SLEEF_MODE_BACKWARD) == 0) {
       void (*func)(real *, uint32_t *, const int, const real *, const int, const real *, const int) = BUTF[config][p->isa][N];
       (*func)(d, p->perm[level], log2len-level, s, log2len-N, p->tbl[N][level], K);
@@ -212,6 +348,57 @@ static void dispatch(SleefDFT *p, const int N, real *d, const real *s, const int
   }
 }
 
+#ifdef CONVMAX
+// The variants of the first and the last stages that convert the input
+// or the output. They are only used in paths with two or more stages,
+// where the first stage is tbut and the last stage is dft.
+
+static void dispatchConvIn(SleefDFT *p, const int N, real *d, const void *s, const int level, const int config, const int conv, const real scale) {
+  const int K = constK[N], log2len = p->log2len;
+  assert(level == log2len && N < level);
+  void (*func)(real *, uint32_t *, const void *, const int, const real *, const int, const real) =
+    ((p->mode & SLEEF_MODE_BACKWARD) == 0 ? TBUTFX : TBUTBX)[conv][config][p->isa][N];
+  (*func)(d, p->perm[level], s, log2len-N, p->tbl[N][level], K, scale);
+}
+
+static void dispatchConvOut(SleefDFT *p, const int N, void *d, const real *s, const int level, const int config, const int conv, const real scale) {
+  assert(level == N && N < p->log2len);
+  void (*func)(void *, const real *, const int, const real) =
+    ((p->mode & SLEEF_MODE_BACKWARD) == 0 ? DFTFX : DFTBX)[conv][config][p->isa][N];
+  (*func)(d, s, p->log2len-N, scale);
+}
+
+static int convIndex(uint64_t mode) {
+  if ((mode & SLEEF_MODE_FP16) != 0) return CONV_FP16;
+  if ((mode & SLEEF_MODE_BF16) != 0) return CONV_BF16;
+  if ((mode & SLEEF_MODE_INT16) != 0) return CONV_INT16;
+  if ((mode & SLEEF_MODE_INT32) != 0) return CONV_INT32;
+  switch(mode & SLEEF_MODE_POSTBITS) {
+  case SLEEF_MODE_POWER: return CONV_POWER;
+  case SLEEF_MODE_MAGNITUDE: return CONV_MAGNITUDE;
+  case SLEEF_MODE_POWERDB: return CONV_POWERDB;
+  case SLEEF_MODE_PHASE: return CONV_PHASE;
+  }
+  return CONV_NONE;
+}
+#endif
+
+// Whether the input or the output in another format of a 1D transform
+// is converted, or the spectrum is post-processed, by the first or the
+// last stage. The data of the other transforms is converted in a
+// staging buffer, and their spectrum is post-processed in place.
+static int convertsInStages(uint64_t mode, int log2len) {
+#ifdef CONVMAX
+  return log2len > MAXBUTWIDTH && convIndex(mode) != CONV_NONE;
+#else
+  return 0;
+#endif
+}
+
+static int isAligned(SleefDFT *p, const void *ptr) {
+  return ((uintptr_t)ptr & (p->vecwidth * 2 * sizeof(real) - 1)) == 0;
+}
+
 // Transposer
 
 #if defined(__GNUC__) && __GNUC__ < 5
@@ -229,7 +416,7 @@ static void dispatch(SleefDFT *p, const int N, real *d, const real *s, const int
       *(element_t *)&row[x2].r[y2*2+0] = r;				\
     }} while(0)
 
-static void transpose(real *RESTRICT ALIGNED(256) d, real *RESTRICT ALIGNED(256) s, const int log2n, const int log2m) {
+static void transpose(real *RESTRICT d, real *RESTRICT ALIGNED(256) s, const int log2n, const int log2m) {
   if (log2n < LOG2BS || log2m < LOG2BS) {
     for(int y=0;y<(1 << log2n);y++) {
       for(int x=0;x<(1 << log2m);x++) {
@@ -273,7 +460,7 @@ static void transpose(real *RESTRICT ALIGNED(256) d, real *RESTRICT ALIGNED(256)
 	}
 #endif
 	for(int y2=0;y2<BS;y2++) {
-	  *(row_t *)&d[(((x+y2) << log2n)+y)*2] = row[y2];
+	  memcpy(&d[(((x+y2) << log2n)+y)*2], &row[y2], sizeof(row_t));
 	}
       }
     }
@@ -281,7 +468,7 @@ static void transpose(real *RESTRICT ALIGNED(256) d, real *RESTRICT ALIGNED(256)
 }
 
 #ifdef _OPENMP
-static void transposeMT(real *RESTRICT ALIGNED(256) d, real *RESTRICT ALIGNED(256) s, int log2n, int log2m) {
+static void transposeMT(real *RESTRICT d, real *RESTRICT ALIGNED(256) s, int log2n, int log2m) {
   if (log2n < LOG2BS || log2m < LOG2BS) {
     for(int y=0;y<(1 << log2n);y++) {
       for(int x=0;x<(1 << log2m);x++) {
@@ -327,7 +514,7 @@ static void transposeMT(real *RESTRICT ALIGNED(256) d, real *RESTRICT ALIGNED(25
 	}
 #endif
 	for(int y2=0;y2<BS;y2++) {
-	  *(row_t *)&d[(((x+y2) << log2n)+y)*2] = row[y2];
+	  memcpy(&d[(((x+y2) << log2n)+y)*2], &row[y2], sizeof(row_t));
 	}
       }
     }
@@ -335,6 +522,35 @@ static void transposeMT(real *RESTRICT ALIGNED(256) d, real *RESTRICT ALIGNED(25
 }
 #endif // #ifdef _OPENMP
 
+#if BASETYPEID == 3 || BASETYPEID == 4
+// Sine and cosine of pi*x in the base type. The table arguments are
+// dyadic rationals, so reduction to |t| <= 1/4 is exact, and the
+// Taylor series converges to the full precision within 20 terms.
+
+static sc_t sincospiExt(real x) {
+  const real pi = REALC(3.141592653589793238462643383279502884197);
+
+  int64_t q = (int64_t)(x * 2 + (x < 0 ? (real)-0.5 : (real)0.5));
+  real t = (x - (real)q * (real)0.5) * pi, t2 = t * t;
+
+  real s = 0, c = 0, ts = t, tc = 1;
+  for(int k=1;k<=20;k++) {
+    s += ts; c += tc;
+    ts *= -t2 / (real)((2*k) * (2*k+1));
+    tc *= -t2 / (real)((2*k-1) * (2*k));
+  }
+
+  sc_t r;
+  switch(q & 3) {
+  case 0: r.x =  s; r.y =  c; break;
+  case 1: r.x =  c; r.y = -s; break;
+  case 2: r.x = -s; r.y = -c; break;
+  default: r.x = -c; r.y =  s; break;
+  }
+  return r;
+}
+#endif
+
 // Table generator
 
 static sc_t r2coefsc(int i, int log2len, int level) {
@@ -482,209 +698,126 @@ static int searchForRandomPathRecurse(SleefDFT *p, int level, int *path, int *pa
 
 // Planner
 
-#define NSHORTESTPATHS 15
-#define MAXPATHLEN (MAXLOG2LEN+1)
-#define POSMAX (CONFIGMAX * MAXLOG2LEN * (MAXBUTWIDTH+1))
-
-static int cln2pos(int config, int level, int N) { return (config * MAXLOG2LEN + level) * MAXBUTWIDTH + N; }
-static int pos2config(int pos) { return pos == -1 ? -1 : ((pos - 1) / (MAXBUTWIDTH * MAXLOG2LEN)); }
-static int pos2level(int pos) { return pos == -1 ? -1 : (((pos - 1) / MAXBUTWIDTH) % MAXLOG2LEN); }
-static int pos2N(int pos) { return pos == -1 ? -1 : ((pos - 1) % MAXBUTWIDTH + 1); }
-
-typedef struct {
-  SleefDFT *p;
+#define MAXSHORTESTPATHS 128
 
-  int countu[POSMAX];
-  int path[NSHORTESTPATHS][MAXPATHLEN];
-  int pathLen[NSHORTESTPATHS];
-  uint64_t cost[NSHORTESTPATHS];
-  int nPaths;
+// Planning effort : MEASURE, QUICK, PATIENT, EXHAUSTIVE
+// effortNPaths is the number of the cheapest estimated paths that are
+// measured, with and without CONFIG_MT each
 
-  int *heap;
-  int *heapLen;
-  uint64_t *heapCost;
-  int heapSize, nPathsInHeap;
-} ks_t;
+static const int effortRepeat[] = { 4, 1, 8, 16 };
+static const int effortNIterX4[] = { 4, 1, 8, 16 };
+static const int effortNPaths[] = { 15, 3, 40, MAXSHORTESTPATHS };
 
-static ks_t *ksInit(SleefDFT *p) {
-  ks_t *q = calloc(1, sizeof(ks_t));
-  q->p = p;
-  q->heapSize = 10;
-  q->heap = calloc(q->heapSize, sizeof(int)*MAXPATHLEN);
-  q->heapCost = calloc(q->heapSize, sizeof(uint64_t));
-  q->heapLen = calloc(q->heapSize, sizeof(int));
-  return q;
-}
+static int planEffort(SleefDFT *p) { return (int)((p->mode & SLEEF_MODE_EFFORTBITS) >> 22); }
 
-static void ksDispose(ks_t *q) {
-  free(q->heapCost);
-  free(q->heapLen);
-  free(q->heap);
-  free(q);
+static int planBudgetExhausted(SleefDFT *p) {
+  return p->planDeadline != 0 && Sleef_currentTimeMicros() >= p->planDeadline;
 }
 
-// returns the number of paths in the heap
-static int ksSize(ks_t *q) { return q->nPathsInHeap; }
-
-// adds a path to the heap
-static void ksAddPath(ks_t *q, int *path, int pathLen, uint64_t cost) {
-  assert(pathLen <= MAXPATHLEN);
-
-  if (q->nPathsInHeap == q->heapSize) {
-    q->heapSize *= 2;
-    q->heap = realloc(q->heap, q->heapSize * sizeof(int)*MAXPATHLEN);
-    q->heapCost = realloc(q->heapCost, q->heapSize * sizeof(uint64_t));
-    q->heapLen = realloc(q->heapLen, q->heapSize * sizeof(int));
+// Latency that REALTIME_PERCENTILE percent of executions do not exceed.
+// At most REALTIME_NLAT latencies are recorded for each path, each of
+// which is the average of a batch of consecutive executions.
+
+#define REALTIME_PERCENTILE 99
+#define REALTIME_NLAT 4096
+
+static uint64_t tailLatency(uint64_t *lat, int n) {
+  // Hoare's selection of the k-th smallest latency
+  const int k = (int)((int64_t)(n - 1) * REALTIME_PERCENTILE / 100);
+  int lo = 0, hi = n - 1;
+
+  while(lo < hi) {
+    const uint64_t pivot = lat[(lo + hi) / 2];
+    int i = lo, j = hi;
+    while(i <= j) {
+      while(lat[i] < pivot) i++;
+      while(lat[j] > pivot) j--;
+      if (i <= j) {
+	uint64_t u = lat[i]; lat[i] = lat[j]; lat[j] = u;
+	i++; j--;
+      }
+    }
+    if (k <= j) hi = j; else if (k >= i) lo = i; else break;
   }
 
-  for(int i=0;i<pathLen;i++) q->heap[q->nPathsInHeap * MAXPATHLEN + i] = path[i];
-  q->heapLen[q->nPathsInHeap] = pathLen;
-  q->heapCost[q->nPathsInHeap] = cost;
-  q->nPathsInHeap++;
-}
-
-// returns the cost of n-th paths in the heap
-static uint64_t ksCost(ks_t *q, int n) {
-  assert(0 <= n && n < q->nPathsInHeap);
-  return q->heapCost[n];
+  return lat[k];
 }
 
-// copies the n-th paths in the heap to path, returns its length
-static int ksGetPath(ks_t *q, int *path, int n) {
-  assert(0 <= n && n < q->nPathsInHeap);
-  int len = q->heapLen[n];
-  for(int i=0;i<len;i++) path[i] = q->heap[n * MAXPATHLEN + i];
-  return len;
-}
+// Cost of a stage for PathSearch_kShortest. A stage is charged the
+// cheaper of its variants with and without non-temporal stores.
 
-// removes the n-th paths in the heap
-static void ksRemove(ks_t *q, int n) {
-  assert(0 <= n && n < q->nPathsInHeap);
+typedef struct {
+  SleefDFT *p;
+  int config;
+} pathSearchCtx_t;
 
-  for(int i=n;i<q->nPathsInHeap-1;i++) {
-    int len = q->heapLen[i+1];
-    assert(len < MAXPATHLEN);
-    for(int j=0;j<len;j++) q->heap[i * MAXPATHLEN + j] = q->heap[(i+1) * MAXPATHLEN + j];
-    q->heapLen[i] = q->heapLen[i+1];
-    q->heapCost[i] = q->heapCost[i+1];
-  }
-  q->nPathsInHeap--;
-}
+static uint64_t pathStageCost(void *ctx, int level, int N) {
+  pathSearchCtx_t *c = (pathSearchCtx_t *)ctx;
+  SleefDFT *p = c->p;
 
-// returns the countu value at pos
-static int ksCountu(ks_t *q, int pos) {
-  assert(0 <= pos && pos < POSMAX);
-  return q->countu[pos];
-}
+  // The first stage has to be at least as wide as a vector
+  if (level == (int)p->log2len && N < MAX(p->log2vecwidth, 1)) return 1ULL << 60;
 
-// set the countu value at pos to n
-static void ksSetCountu(ks_t *q, int pos, int n) {
-  assert(0 <= pos && pos < POSMAX);
-  q->countu[pos] = n;
+  uint64_t t0 = p->tm[c->config | 0][level*(MAXBUTWIDTH+1) + N];
+  uint64_t t1 = p->tm[c->config | 1][level*(MAXBUTWIDTH+1) + N];
+  return MIN(t0, t1);
 }
 
-// adds a path as one of the best k paths, returns the number best paths
-static int ksAddBestPath(ks_t *q, int *path, int pathLen, uint64_t cost) {
-  assert(pathLen <= MAXPATHLEN);
-  assert(q->nPaths < NSHORTESTPATHS);
-  for(int i=0;i<pathLen;i++) q->path[q->nPaths][i] = path[i];
-  q->pathLen[q->nPaths] = pathLen;
-  q->cost[q->nPaths] = cost;
-  q->nPaths++;
-  return q->nPaths;
+// The widest stage of a path, which has to leave at least one other stage
+static int pathMaxN(SleefDFT *p) {
+  return MIN(MIN(p->log2len, MAXBUTWIDTH+1), p->log2len - p->log2vecwidth + 1) - 1;
 }
 
-// returns if pos is a destination
-static int ksIsDest(ks_t *q, int pos) { return pos2level(pos) == 0; }
+static void searchForBestPath(SleefDFT *p) {
+  // The cheapest paths are searched separately for the configurations
+  // with and without CONFIG_MT, and then merged in ascending order of
+  // their cost.
 
-// returns n-th adjacent nodes at pos.
-static int ksAdjacent(ks_t *q, int pos, int n) {
-  if (pos != -1 && pos2level(pos) == 0) return -1;
+  const int maxN = pathMaxN(p), k = effortNPaths[planEffort(p)];
+  const int stride = p->log2len + 1;
 
-  int NMAX = MIN(MIN(q->p->log2len, MAXBUTWIDTH+1), q->p->log2len - q->p->log2vecwidth + 1);
+  int32_t (*cpath)[MAXSHORTESTPATHS * (MAXLOG2LEN+1)] = malloc(sizeof(int32_t) * 2 * MAXSHORTESTPATHS * (MAXLOG2LEN+1));
+  uint64_t ccost[2][MAXSHORTESTPATHS];
+  int cn[2];
 
-  if (pos == -1) {
-    int N = n / 2 + MAX(q->p->log2vecwidth, 1);
-    if (N >= NMAX) return -1;
-    return cln2pos((n & 1) * CONFIG_MT, q->p->log2len, N);
+  for(int mt=0;mt<2;mt++) {
+    pathSearchCtx_t ctx = { p, mt ? CONFIG_MT : 0 };
+    cn[mt] = PathSearch_kShortest(p->log2len, maxN, pathStageCost, &ctx, k, cpath[mt], ccost[mt]);
   }
 
-  int config = (pos2config(pos) & CONFIG_MT);
-  int N = n + 1;
-  int level = pos2level(pos) - pos2N(pos);
-
-  if (level < 0 || N >= NMAX) return -1;
-  if (level == 0) return n == 0 ? cln2pos(0, 0, 0) : -1;
+  int32_t (*path)[MAXLOG2LEN+1] = malloc(sizeof(int32_t) * 2 * MAXSHORTESTPATHS * (MAXLOG2LEN+1));
+  uint64_t pathCost[2 * MAXSHORTESTPATHS];
+  int pathMT[2 * MAXSHORTESTPATHS], nPaths = 0;
 
-  return cln2pos(config, level, N);
-}
-
-static uint64_t ksAdjacentCost(ks_t *q, int pos, int n) {
-  int nxpos = ksAdjacent(q, pos, n);
-  if (nxpos == -1) return 0;
-  int config = pos2config(nxpos), level = pos2level(nxpos), N = pos2N(nxpos);
-  uint64_t ret0 = q->p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
-  uint64_t ret1 = q->p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
-  return MIN(ret0, ret1);
-}
-
-static void searchForBestPath(SleefDFT *p) {
-  ks_t *q = ksInit(p);
-
-  for(int i=0;;i++) {
-    int v = ksAdjacent(q, -1, i);
-    if (v == -1) break;
-    uint64_t c = ksAdjacentCost(q, -1, i);
-    int path[1] = { v };
-    ksAddPath(q, path, 1, c);
+  for(int i0=0, i1=0;i0 < cn[0] || i1 < cn[1];nPaths++) {
+    const int mt = i0 < cn[0] && (i1 >= cn[1] || ccost[0][i0] <= ccost[1][i1]) ? 0 : 1;
+    const int i = mt ? i1++ : i0++;
+    for(int level=0;level<stride;level++) path[nPaths][level] = cpath[mt][i * stride + level];
+    pathCost[nPaths] = ccost[mt][i];
+    pathMT[nPaths] = mt;
   }
 
-  while(ksSize(q) != 0) {
-    uint64_t bestCost = 1ULL << 60;
-    int bestPathNum = -1;
-
-    for(int i=0;i<ksSize(q);i++) {
-      if (ksCost(q, i) < bestCost) {
-	bestCost = ksCost(q, i);
-	bestPathNum = i;
-      }
-    }
-    if (bestPathNum == -1) break;
-
-    int path[MAXPATHLEN];
-    int pathLen = ksGetPath(q, path, bestPathNum);
-    uint64_t cost = ksCost(q, bestPathNum);
-    ksRemove(q, bestPathNum);
+  free(cpath);
 
-    int lastPos = path[pathLen-1];
-    if (ksCountu(q, lastPos) >= NSHORTESTPATHS) continue;
-    ksSetCountu(q, lastPos, ksCountu(q, lastPos)+1);
-
-    if (ksIsDest(q, lastPos)) {
-      if (ksAddBestPath(q, path, pathLen, cost) >= NSHORTESTPATHS) break;
-      continue;
-    }
+  for(int j = p->log2len;j >= 0;j--) p->bestPath[j] = 0;
 
-    for(int i=0;;i++) {
-      int v = ksAdjacent(q, lastPos, i);
-      if (v == -1) break;
-      assert(0 <= pos2N(v) && pos2N(v) <= q->p->log2len);
-      uint64_t c = ksAdjacentCost(q, lastPos, i);
-      path[pathLen] = v;
-      ksAddPath(q, path, pathLen+1, cost + c);
-    }
+  if (nPaths == 0) {
+    free(path);
+    return;
   }
 
-  for(int j = p->log2len;j >= 0;j--) p->bestPath[j] = 0;
-
-  if (((p->mode & SLEEF_MODE_MEASURE) != 0 || (planFilePathSet && (p->mode & SLEEF_MODE_MEASUREBITS) == 0))) {
+  if (((p->mode & SLEEF_MODE_MEASURE) != 0 || (planFilePathSet && (p->mode & SLEEF_MODE_MEASUREBITS) == 0)) && !p->asyncPending) {
     uint64_t besttm = 1ULL << 62;
     int bestPath = -1;
-    const int niter =  1 + 5000000 / ((1 << p->log2len) + 1);
+    const int niter =  1 + 5000000 / ((1 << p->log2len) + 1) * effortNIterX4[planEffort(p)] / 4;
+    const int nSample = MAX(effortRepeat[planEffort(p)] / 2, 2);
 
+    // In SLEEF_MODE_UNALIGNED, paths are measured with buffers not aligned to vectors
+    const int unaligned = (p->mode & SLEEF_MODE_UNALIGNED) != 0, ofs = unaligned ? 2 : 0;
     real *s2 = NULL, *d2 = NULL;
-    const real *s = p->in  == NULL ? (s2 = (real *)memset(Sleef_malloc((2 << p->log2len) * sizeof(real)), 0, sizeof(real) * (2 << p->log2len))) : p->in;
-    real       *d = p->out == NULL ? (d2 = (real *)memset(Sleef_malloc((2 << p->log2len) * sizeof(real)), 0, sizeof(real) * (2 << p->log2len))) : p->out;
+    const real *s = p->in  == NULL || unaligned ? (s2 = (real *)memset(Sleef_malloc(((2 << p->log2len) + ofs) * sizeof(real)), 0, sizeof(real) * ((2 << p->log2len) + ofs))) + ofs : p->in;
+    real       *d = p->out == NULL || unaligned ? (d2 = (real *)memset(Sleef_malloc(((2 << p->log2len) + ofs) * sizeof(real)), 0, sizeof(real) * ((2 << p->log2len) + ofs))) + ofs : p->out;
+    const int sAligned = isAligned(p, s), dAligned = isAligned(p, d);
 
 #ifdef _OPENMP
     const int tn = omp_get_thread_num();
@@ -692,84 +825,91 @@ static void searchForBestPath(SleefDFT *p) {
     const int tn = 0;
 #endif
 
-    real *t[] = { p->x1[tn], p->x0[tn], d };
+    real *t[] = { p->x1[tn], p->x0[tn], dAligned ? d : p->x1[tn] };
+
+    // In SLEEF_MODE_REALTIME, batches of executions are timed, and paths
+    // are compared by the tail percentile of the latency. They are
+    // compared by the average if the latencies cannot be recorded.
+    const int64_t nExec = (int64_t)niter * nSample;
+    const int nLat = (int)MIN(nExec, REALTIME_NLAT), batch = (int)((nExec + nLat - 1) / nLat);
+    uint64_t *lat = (p->mode & SLEEF_MODE_REALTIME) != 0 ? (uint64_t *)malloc(sizeof(uint64_t) * nLat) : NULL;
+    const int realtime = lat != NULL;
 
-    for(int mt=0;mt<2;mt++) {
-      for(int i=q->nPaths-1;i>=0;i--) {
-	if (((pos2config(q->path[i][0]) & CONFIG_MT) != 0) != mt) continue;
+    for(int mt=0;mt<2 && !p->planTruncated;mt++) {
+      // Paths are tried in ascending order of their estimated cost
+      for(int i=0, nMeasured=0;i<nPaths && nMeasured < k;i++) {
+	if (pathMT[i] != mt) continue;
+
+	if (bestPath != -1 && planBudgetExhausted(p)) {
+	  p->planTruncated = 1;
+	  break;
+	}
+	nMeasured++;
 
 	if ((p->mode & SLEEF_MODE_VERBOSE) != 0) {
-	  for(int j=0;j<q->pathLen[i];j++) {
-	    int N = pos2N(q->path[i][j]);
-	    int level = pos2level(q->path[i][j]);
-	    int config = pos2config(q->path[i][j]) & ~1;
-	    uint64_t t0 = q->p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
-	    uint64_t t1 = q->p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
+	  for(int level = p->log2len;level >= 1;) {
+	    int N = path[i][level];
+	    int config = pathMT[i] ? CONFIG_MT : 0;
+	    uint64_t t0 = p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
+	    uint64_t t1 = p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
 	    config = t0 < t1 ? config : (config | 1);
 
-	    if (N != 0) printf("%d(%s) ", N, configStr[config]);
+	    printf("%d(%s) ", N, configStr[config]);
+	    level -= N;
 	  }
 	}
 
 	if (mt) startAllThreads(p->nThread);
 
-	uint64_t tm0 = Sleef_currentTimeMicros();
-	for(int k=0;k<niter;k++) {
-	  int nb = 0;
-	  const real *lb = s;
-	  if ((p->pathLen & 1) == 1) nb = -1;
-	  for(int level = p->log2len, j=0;level >= 1;j++) {
-	    assert(pos2level(q->path[i][j]) == level);
-	    int N = pos2N(q->path[i][j]);
-	    int config = pos2config(q->path[i][j]) & ~1;
-	    uint64_t t0 = q->p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
-	    uint64_t t1 = q->p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
-	    config = t0 < t1 ? config : (config | 1);
-	    dispatch(p, N, t[nb+1], lb, level, config);
-	    level -= N;
-	    lb = t[nb+1];
-	    nb = (nb + 1) & 1;
-	  }
-	}
-	uint64_t tm1 = Sleef_currentTimeMicros();
-	for(int k=0;k<niter;k++) {
-	  int nb = 0;
-	  const real *lb = s;
-	  if ((p->pathLen & 1) == 1) nb = -1;
-	  for(int level = p->log2len, j=0;level >= 1;j++) {
-	    assert(pos2level(q->path[i][j]) == level);
-	    int N = pos2N(q->path[i][j]);
-	    int config = pos2config(q->path[i][j]) & ~1;
-	    uint64_t t0 = q->p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
-	    uint64_t t1 = q->p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
-	    config = t0 < t1 ? config : (config | 1);
-	    dispatch(p, N, t[nb+1], lb, level, config);
-	    level -= N;
-	    lb = t[nb+1];
-	    nb = (nb + 1) & 1;
+	uint64_t tmPath = 1ULL << 62, tb = 0;
+	int nl = 0;
+	for(int sample=0;sample<nSample;sample++) {
+	  uint64_t tm0 = Sleef_readCycleCounter();
+	  for(int k=0;k<niter;k++) {
+	    const int64_t e = (int64_t)sample * niter + k;
+	    if (realtime && e % batch == 0) tb = Sleef_readCycleCounter();
+	    int nb = 0;
+	    const real *lb = s;
+	    if ((p->pathLen & 1) == 1) nb = -1;
+	    for(int level = p->log2len;level >= 1;) {
+	      int N = path[i][level];
+	      int config = pathMT[i] ? CONFIG_MT : 0;
+	      uint64_t t0 = p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
+	      uint64_t t1 = p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
+	      config = t0 < t1 ? config : (config | 1);
+	      real *out = level == N ? d : t[nb+1];
+	      dispatch(p, N, out, lb, level, config, (lb == s && !sAligned) || (out == d && !dAligned));
+	      level -= N;
+	      lb = t[nb+1];
+	      nb = (nb + 1) & 1;
+	    }
+	    if (realtime && (e % batch == batch - 1 || e == nExec - 1)) lat[nl++] = (Sleef_readCycleCounter() - tb) / (e % batch + 1);
 	  }
+	  uint64_t tm = Sleef_readCycleCounter() - tm0;
+	  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("%s%lld", sample == 0 ? " : " : " ", (long long int)tm);
+	  tmPath = MIN(tmPath, tm);
 	}
-	uint64_t tm2 = Sleef_currentTimeMicros();
+	if (realtime) tmPath = tailLatency(lat, nl) * niter;
+	if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("\n");
 
-	if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf(" : %lld %lld\n", (long long int)(tm1 - tm0), (long long int)(tm2 - tm1));
-	if ((tm1 - tm0) < besttm) {
+	if (tmPath < besttm) {
 	  bestPath = i;
-	  besttm = tm1 - tm0;
-	}
-	if ((tm2 - tm1) < besttm) {
-	  bestPath = i;
-	  besttm = tm2 - tm1;
+	  besttm = tmPath;
 	}
       }
     }
 
-    for(int level = p->log2len, j=0;level >= 1;j++) {
-      assert(pos2level(q->path[bestPath][j]) == level);
-      int N = pos2N(q->path[bestPath][j]);
+    if (bestPath == -1) bestPath = 0;
+
+    p->estimatedTime = p->tmDivisor == 0 ? 0 : pathCost[bestPath] / p->tmDivisor;
+    p->measuredTime = besttm == 1ULL << 62 ? 0 : besttm / niter;
+
+    for(int level = p->log2len;level >= 1;) {
+      int N = path[bestPath][level];
 
-      int config = pos2config(q->path[bestPath][j]) & ~1;
-      uint64_t t0 = q->p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
-      uint64_t t1 = q->p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
+      int config = pathMT[bestPath] ? CONFIG_MT : 0;
+      uint64_t t0 = p->tm[config | 0][level*(MAXBUTWIDTH+1) + N];
+      uint64_t t1 = p->tm[config | 1][level*(MAXBUTWIDTH+1) + N];
       config = t0 < t1 ? config : (config | 1);
 
       p->bestPath[level] = N;
@@ -777,29 +917,61 @@ static void searchForBestPath(SleefDFT *p) {
       level -= N;
     }
 
+    free(lat);
     if (d2 != NULL) Sleef_free(d2);
     if (s2 != NULL) Sleef_free(s2);
   } else {
-    for(int level = p->log2len, j=0;level >= 1;j++) {
-      int bestPath = 0;
-      assert(pos2level(q->path[bestPath][j]) == level);
-      int N = pos2N(q->path[bestPath][j]);
-      int config = pos2config(q->path[bestPath][j]);
+    p->estimatedTime = p->tmDivisor == 0 ? 0 : pathCost[0] / p->tmDivisor;
+
+    for(int level = p->log2len;level >= 1;) {
+      int N = path[0][level];
+      int config = pathMT[0] ? CONFIG_MT : 0;
       p->bestPath[level] = N;
       p->bestPathConfig[level] = config;
       level -= N;
     }
   }
 
-  ksDispose(q);
+  free(path);
+}
+
+// In SLEEF_MODE_REPRODUCIBLE, the path with the fewest stages is
+// chosen regardless of the costs, so that the order of operations only
+// depends on n. The configuration of each stage does not change the
+// results, and the cheapest one is chosen.
+
+static uint64_t reproducibleStageCost(void *ctx, int level, int N) {
+  SleefDFT *p = (SleefDFT *)ctx;
+  if (level == (int)p->log2len && N < MAX(p->log2vecwidth, 1)) return 1ULL << 60;
+  return p->tm[0][level*(MAXBUTWIDTH+1) + N] < 1ULL << 60 ? 1 : 1ULL << 60;
+}
+
+static void searchForReproduciblePath(SleefDFT *p) {
+  int32_t path[MAXLOG2LEN+1];
+  uint64_t nStage, cost = 0;
+
+  for(int j = p->log2len;j >= 0;j--) p->bestPath[j] = 0;
+
+  if (PathSearch_kShortest(p->log2len, pathMaxN(p), reproducibleStageCost, p, 1, path, &nStage) == 0) return;
+
+  for(int level = p->log2len;level >= 1;) {
+    int N = path[level], config = 0;
+    for(int c=1;c<CONFIGMAX;c++) {
+      if (p->tm[c][level*(MAXBUTWIDTH+1) + N] < p->tm[config][level*(MAXBUTWIDTH+1) + N]) config = c;
+    }
+    cost += p->tm[config][level*(MAXBUTWIDTH+1) + N];
+    p->bestPath[level] = N;
+    p->bestPathConfig[level] = config;
+    level -= N;
+  }
+
+  p->estimatedTime = p->tmDivisor == 0 ? 0 : cost / p->tmDivisor;
 }
 
 //
 
-static uint64_t estimate(int log2len, int level, int N, int config) {
-  uint64_t ret = N * 1000 + ABS(N-3) * 1000;
-  if (log2len >= 14 && (config & CONFIG_MT) != 0) ret /= 2;
-  return ret;
+static int measureButNIter(SleefDFT *p) {
+  return 1 + 100000 / ((1 << p->log2len) + 1) * effortNIterX4[planEffort(p)] / 4;
 }
 
 static void measureBut(SleefDFT *p) {
@@ -816,15 +988,31 @@ static void measureBut(SleefDFT *p) {
   real *s = (real *)memset(p->x0[tn], 0, sizeof(real) * (2 << p->log2len));
   real *d = (real *)memset(p->x1[tn], 0, sizeof(real) * (2 << p->log2len));
 
-  const int niter =  1 + 100000 / ((1 << p->log2len) + 1);
+  // The first and the last stages read and write buffers given by the
+  // user, which may not be aligned to vectors in SLEEF_MODE_UNALIGNED
+  const int unaligned = (p->mode & SLEEF_MODE_UNALIGNED) != 0;
+  real *ub = NULL, *u = NULL;
+  if (unaligned) {
+    ub = (real *)memset(Sleef_malloc(sizeof(real) * ((2 << p->log2len) + 2)), 0, sizeof(real) * ((2 << p->log2len) + 2));
+    u = ub + 2;
+  }
+
+  const int effort = planEffort(p);
+  const int niter = measureButNIter(p);
 
-#define MEASURE_REPEAT 4
+  // Non-temporal stores do not pay off if the whole data fits in cache
+  const int pruneStream = effort == 1 && (sizeof(real) << (p->log2len + 2)) <= (1 << 20);
 
-  for(int rep=1;rep<=MEASURE_REPEAT;rep++) {
+  for(int rep=1;rep<=effortRepeat[effort];rep++) {
+    if (rep > 1 && planBudgetExhausted(p)) {
+      p->planTruncated = 1;
+      break;
+    }
     for(int config=0;config<CONFIGMAX;config++) {
 #if ENABLE_STREAM == 0
       if ((config & 1) != 0) continue;
 #endif
+      if (pruneStream && (config & CONFIG_STREAM) != 0) continue;
       if ((p->mode2 & SLEEF_MODE2_MT1D) == 0 && (config & CONFIG_MT) != 0) continue;
       for(uint32_t level = p->log2len;level >= 1;level--) {
 	for(uint32_t N=1;N<=MAXBUTWIDTH;N++) {
@@ -832,11 +1020,11 @@ static void measureBut(SleefDFT *p) {
 	  if (level == N) {
 	    if ((int)p->log2len - (int)level < p->log2vecwidth) continue;
 
-	    uint64_t tm = Sleef_currentTimeMicros();
+	    uint64_t tm = Sleef_readCycleCounter();
 	    for(int i=0;i<niter*2;i++) {
-	      dispatch(p, N, d, s, level, config);
+	      dispatch(p, N, unaligned ? u : d, s, level, config, unaligned);
 	    }
-	    tm = Sleef_currentTimeMicros() - tm + 1;
+	    tm = Sleef_readCycleCounter() - tm + 1;
 	    p->tm[config][level*(MAXBUTWIDTH+1)+N] = MIN(p->tm[config][level*(MAXBUTWIDTH+1)+N], tm);
 	  } else if (level == p->log2len) {
 	    if (p->tbl[N] == NULL || p->tbl[N][level] == NULL) continue;
@@ -856,12 +1044,12 @@ static void measureBut(SleefDFT *p) {
 	      }
 	    }
 
-	    uint64_t tm = Sleef_currentTimeMicros();
+	    uint64_t tm = Sleef_readCycleCounter();
 	    for(int i=0;i<niter;i++) {
-	      dispatch(p, N, d, s, level, config);
-	      dispatch(p, N, s, d, level, config);
+	      dispatch(p, N, d, unaligned ? u : s, level, config, unaligned);
+	      dispatch(p, N, s, unaligned ? u : d, level, config, unaligned);
 	    }
-	    tm = Sleef_currentTimeMicros() - tm + 1;
+	    tm = Sleef_readCycleCounter() - tm + 1;
 	    p->tm[config][level*(MAXBUTWIDTH+1)+N] = MIN(p->tm[config][level*(MAXBUTWIDTH+1)+N], tm);
 	  } else {
 	    if (p->tbl[N] == NULL || p->tbl[N][level] == NULL) continue;
@@ -882,12 +1070,12 @@ static void measureBut(SleefDFT *p) {
 	      }
 	    }
 
-	    uint64_t tm = Sleef_currentTimeMicros();
+	    uint64_t tm = Sleef_readCycleCounter();
 	    for(int i=0;i<niter;i++) {
-	      dispatch(p, N, d, s, level, config);
-	      dispatch(p, N, s, d, level, config);
+	      dispatch(p, N, d, s, level, config, 0);
+	      dispatch(p, N, s, d, level, config, 0);
 	    }
-	    tm = Sleef_currentTimeMicros() - tm + 1;
+	    tm = Sleef_readCycleCounter() - tm + 1;
 	    p->tm[config][level*(MAXBUTWIDTH+1)+N] = MIN(p->tm[config][level*(MAXBUTWIDTH+1)+N], tm);
 	  }
 	}
@@ -895,6 +1083,8 @@ static void measureBut(SleefDFT *p) {
     }
   }
 
+  if (ub != NULL) Sleef_free(ub);
+
   if ((p->mode & SLEEF_MODE_VERBOSE) != 0) {
     for(uint32_t level = p->log2len;level >= 1;level--) {
       for(uint32_t N=1;N<=MAXBUTWIDTH;N++) {
@@ -941,7 +1131,183 @@ static void measureBut(SleefDFT *p) {
   }
 }
 
-static void estimateBut(SleefDFT *p) {
+// Cost model for estimation
+//
+// Throughput of each butterfly with in-cache data and the memory
+// bandwidth for each working set size are measured once, and the
+// results are kept in the plan file. The cost of a butterfly is then
+// predicted as the larger one of the computation time and the memory
+// access time. Values are in the unit of Sleef_readCycleCounter,
+// with COSTMODEL_FIXEDBITS fractional bits.
+
+#define COSTMODEL_FIXEDBITS 16
+#define CALIB_LOG2LEN 10
+#define CALIB_LOG2BWMIN 14
+#define CALIB_LOG2BWMAX 25
+
+#define COSTMODEL_VALID 0
+#define COSTMODEL_BUT(N) (N)
+#define COSTMODEL_BW(k) (8 + (k) - CALIB_LOG2BWMIN)
+#define COSTMODEL_BWMT COSTMODEL_BW(CALIB_LOG2BWMAX + 1)
+#define COSTMODEL_FORK (COSTMODEL_BWMT + 1)
+#define COSTMODEL_NITEM (COSTMODEL_FORK + 1)
+
+static uint64_t copyTicks(real *d, const real *s, size_t nElem, int nRep, int mt) {
+  uint64_t best = 1ULL << 62;
+  for(int trial=0;trial<2;trial++) {
+    uint64_t tm = Sleef_readCycleCounter();
+    for(int r=0;r<nRep;r++) {
+      const real c = (real)r;
+#ifdef _OPENMP
+      if (mt) {
+	int64_t i;
+#pragma omp parallel for
+	for(i=0;i<(int64_t)nElem;i++) d[i] = s[i] + c;
+	continue;
+      }
+#endif
+      for(size_t i=0;i<nElem;i++) d[i] = s[i] + c;
+    }
+    best = MIN(best, Sleef_readCycleCounter() - tm);
+  }
+  return best;
+}
+
+static SleefDFT *init1d(uint32_t n, const real *in, real *out, uint64_t mode, int isa);
+
+static int calibrateCostModel(SleefDFT *p, uint64_t *model) {
+  for(int i=0;i<COSTMODEL_NITEM;i++) model[i] = 0;
+
+  // Butterflies of the ISA of the plan
+
+  SleefDFT *q = init1d(1 << CALIB_LOG2LEN, NULL, NULL, SLEEF_MODE_ESTIMATE | SLEEF_MODE_NO_MT | SLEEF_MODE_NOCOSTMODEL, p->isa);
+  if (q == NULL) return 0;
+
+  q->mode = (q->mode & ~(uint64_t)(SLEEF_MODE_MEASUREBITS | SLEEF_MODE_EFFORTBITS)) | SLEEF_MODE_QUICK;
+
+  for(int level=0;level<=(int)q->log2len;level++) {
+    for(int N=0;N<=MAXBUTWIDTH;N++) {
+      for(int config=0;config<CONFIGMAX;config++) q->tm[config][level*(MAXBUTWIDTH+1)+N] = 1ULL << 60;
+    }
+  }
+
+  measureBut(q);
+
+  const uint64_t nDispatch = 2 * (uint64_t)measureButNIter(q);
+  uint64_t worst = 0;
+
+  for(int N=1;N<=MAXBUTWIDTH;N++) {
+    uint64_t sum = 0, cnt = 0;
+    for(int level=1;level<=(int)q->log2len;level++) {
+      uint64_t t = q->tm[0][level*(MAXBUTWIDTH+1)+N];
+      if (t >= (1ULL << 60)) continue;
+      sum += t;
+      cnt++;
+    }
+    if (cnt == 0) continue;
+    model[COSTMODEL_BUT(N)] = ((sum / cnt) << COSTMODEL_FIXEDBITS) / (nDispatch << CALIB_LOG2LEN) + 1;
+    worst = MAX(worst, model[COSTMODEL_BUT(N)]);
+  }
+
+  SleefDFT_dispose(q);
+
+  if (worst == 0) return 0;
+  for(int N=1;N<=MAXBUTWIDTH;N++) if (model[COSTMODEL_BUT(N)] == 0) model[COSTMODEL_BUT(N)] = worst * 4;
+
+  // Memory bandwidth
+
+  real *bs = (real *)memset(Sleef_malloc(1 << CALIB_LOG2BWMAX), 0, 1 << CALIB_LOG2BWMAX);
+  real *bd = (real *)memset(Sleef_malloc(1 << CALIB_LOG2BWMAX), 0, 1 << CALIB_LOG2BWMAX);
+
+  for(int k=CALIB_LOG2BWMIN;k<=CALIB_LOG2BWMAX;k++) {
+    const int nRep = MAX(1, (1 << 24) >> k);
+    uint64_t tm = copyTicks(bd, bs, ((size_t)1 << k) / sizeof(real), nRep, 0);
+    model[COSTMODEL_BW(k)] = (tm << COSTMODEL_FIXEDBITS) / ((uint64_t)nRep << (k + 1)) + 1;
+  }
+
+  uint64_t tm = copyTicks(bd, bs, ((size_t)1 << CALIB_LOG2BWMAX) / sizeof(real), 1, 1);
+  model[COSTMODEL_BWMT] = (tm << COSTMODEL_FIXEDBITS) / ((uint64_t)1 << (CALIB_LOG2BWMAX + 1)) + 1;
+
+  Sleef_free(bd);
+  Sleef_free(bs);
+
+  // Overhead of starting a parallel region
+
+#ifdef _OPENMP
+  uint64_t fork = 1ULL << 62;
+  for(int trial=0;trial<4;trial++) {
+    tm = Sleef_readCycleCounter();
+    for(int r=0;r<100;r++) {
+#pragma omp parallel
+      {
+      }
+    }
+    fork = MIN(fork, (Sleef_readCycleCounter() - tm) / 100);
+  }
+  model[COSTMODEL_FORK] = fork << COSTMODEL_FIXEDBITS;
+#endif
+
+  model[COSTMODEL_VALID] = 1;
+
+  return 1;
+}
+
+static int getCostModel(SleefDFT *p, uint64_t *model) {
+  if ((p->mode & SLEEF_MODE_NOCOSTMODEL) != 0) return 0;
+
+  if (PlanManager_loadCostModel(p->baseTypeID, p->isa, model, COSTMODEL_NITEM)) {
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Cost model : loaded\n");
+    return 1;
+  }
+
+  if (!PlanManager_costModelWritable() || !calibrateCostModel(p, model)) return 0;
+
+  PlanManager_saveCostModel(p->baseTypeID, p->isa, model, COSTMODEL_NITEM);
+  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Cost model : calibrated\n");
+
+  return 1;
+}
+
+static uint64_t estimate(SleefDFT *p, const uint64_t *model, int level, int N, int config) {
+  if (model == NULL) {
+    uint64_t ret = N * 1000 + ABS(N-3) * 1000;
+    if (p->log2len >= 14 && (config & CONFIG_MT) != 0) ret /= 2;
+    return ret;
+  }
+
+  if ((config & CONFIG_MT) != 0 && (p->mode2 & SLEEF_MODE2_MT1D) == 0) return 1ULL << 60;
+
+  const double fb = 1.0 / (1 << COSTMODEL_FIXEDBITS);
+  const double n = (double)(1ULL << p->log2len), bytes = n * 2 * sizeof(real);
+  const int k = MAX(MIN((int)p->log2len + ilog2(2 * sizeof(real)), CALIB_LOG2BWMAX), CALIB_LOG2BWMIN);
+
+  const double tpb = model[COSTMODEL_BW(k)] * fb;
+  const double tpbMin = model[COSTMODEL_BW(CALIB_LOG2BWMIN)] * fb, tpbMem = model[COSTMODEL_BW(CALIB_LOG2BWMAX)] * fb;
+
+  // How much of the data is in memory rather than in cache. Non-temporal
+  // stores always go to memory, but they save the read for ownership.
+  double f = tpbMem > tpbMin ? (tpb - tpbMin) / (tpbMem - tpbMin) : 1;
+  f = f < 0 ? 0 : (f > 1 ? 1 : f);
+  if ((config & CONFIG_STREAM) != 0) f = 1;
+  const double ntFactor = (config & CONFIG_STREAM) != 0 ? 2.0 / 3.0 : 1.0;
+
+  double compute = model[COSTMODEL_BUT(N)] * fb * n;
+  double mem = 2 * bytes * (tpbMin * (1 - f) + tpbMem * ntFactor * f);
+
+  if ((config & CONFIG_MT) != 0) {
+    compute /= p->nThread;
+    mem = 2 * bytes * (tpbMin * (1 - f) / p->nThread + model[COSTMODEL_BWMT] * fb * ntFactor * f);
+    return (uint64_t)(MAX(compute, mem) + model[COSTMODEL_FORK] * fb) + 1;
+  }
+
+  return (uint64_t)MAX(compute, mem) + 1;
+}
+
+// Returns 1 if the estimates are in timer ticks per call
+static int estimateBut(SleefDFT *p) {
+  uint64_t modelBuf[COSTMODEL_NITEM];
+  const uint64_t *model = getCostModel(p, modelBuf) ? modelBuf : NULL;
+
   for(uint32_t level = p->log2len;level >= 1;level--) {
     for(uint32_t N=1;N<=MAXBUTWIDTH;N++) {
       if (level < N || p->log2len <= N) continue;
@@ -951,7 +1317,7 @@ static void estimateBut(SleefDFT *p) {
 #if ENABLE_STREAM == 0
 	  if ((config & 1) != 0) continue;
 #endif
-	  p->tm[config][level*(MAXBUTWIDTH+1)+N] = estimate(p->log2len, level, N, config);
+	  p->tm[config][level*(MAXBUTWIDTH+1)+N] = estimate(p, model, level, N, config);
 	}
       } else if (level == p->log2len) {
 	if (p->tbl[N] == NULL || p->tbl[N][level] == NULL) continue;
@@ -960,7 +1326,7 @@ static void estimateBut(SleefDFT *p) {
 #if ENABLE_STREAM == 0
 	  if ((config & 1) != 0) continue;
 #endif
-	  p->tm[config][level*(MAXBUTWIDTH+1)+N] = estimate(p->log2len, level, N, config);
+	  p->tm[config][level*(MAXBUTWIDTH+1)+N] = estimate(p, model, level, N, config);
 	}
       } else {
 	if (p->tbl[N] == NULL || p->tbl[N][level] == NULL) continue;
@@ -970,11 +1336,19 @@ static void estimateBut(SleefDFT *p) {
 #if ENABLE_STREAM == 0
 	  if ((config & 1) != 0) continue;
 #endif
-	  p->tm[config][level*(MAXBUTWIDTH+1)+N] = estimate(p->log2len, level, N, config);
+	  p->tm[config][level*(MAXBUTWIDTH+1)+N] = estimate(p, model, level, N, config);
 	}
       }
     }
   }
+
+  return model != NULL;
+}
+
+// Plans measured with unaligned buffers or for tail latency are kept separately
+static int pathCategory(SleefDFT *p) {
+  return ((p->mode & SLEEF_MODE_NO_MT) != 0 ? 1 : 0) + ((p->mode & SLEEF_MODE_UNALIGNED) != 0 ? 2 : 0) +
+    ((p->mode & SLEEF_MODE_REALTIME) != 0 ? 4 : 0);
 }
 
 static int measure(SleefDFT *p, int randomize) {
@@ -987,7 +1361,9 @@ static int measure(SleefDFT *p, int randomize) {
     return 1;
   }
 
-  if (PlanManager_loadMeasurementResultsP(p, (p->mode & SLEEF_MODE_NO_MT) != 0 ? 1 : 0)) {
+  const int reproducible = (p->mode & SLEEF_MODE_REPRODUCIBLE) != 0;
+
+  if (!reproducible && PlanManager_loadMeasurementResultsP(p, pathCategory(p))) {
     if ((p->mode & SLEEF_MODE_VERBOSE) != 0) {
       printf("Path(loaded) : ");
       for(int j = p->log2len;j >= 0;j--) if (p->bestPath[j] != 0) printf("%d(%s) ", p->bestPath[j], configStr[p->bestPathConfig[j]]);
@@ -1007,11 +1383,20 @@ static int measure(SleefDFT *p, int randomize) {
     }
   }
   
-  if (((p->mode & SLEEF_MODE_MEASURE) != 0 || (planFilePathSet && (p->mode & SLEEF_MODE_MEASUREBITS) == 0)) && !randomize) {
-    measureBut(p);
-    toBeSaved = 1;
+  if (((p->mode & SLEEF_MODE_MEASURE) != 0 || (planFilePathSet && (p->mode & SLEEF_MODE_MEASUREBITS) == 0)) && !randomize && !reproducible) {
+#ifdef _OPENMP
+    if ((p->mode & SLEEF_MODE_ASYNC) != 0) {
+      p->tmDivisor = estimateBut(p);
+      p->asyncPending = 1;
+    } else
+#endif
+    {
+      measureBut(p);
+      p->tmDivisor = 2 * measureButNIter(p);
+      toBeSaved = 1;
+    }
   } else {
-    estimateBut(p);
+    p->tmDivisor = estimateBut(p);
   }
 
   int executable = 0;
@@ -1025,7 +1410,9 @@ static int measure(SleefDFT *p, int randomize) {
 
   p->bestPath[p->log2len] = 0;
   
-  if (!randomize) {
+  if (reproducible) {
+    searchForReproduciblePath(p);
+  } else if (!randomize) {
     searchForBestPath(p);
   } else {
     int path[MAXLOG2LEN+1];
@@ -1045,16 +1432,20 @@ static int measure(SleefDFT *p, int randomize) {
 
   if ((p->mode & SLEEF_MODE_VERBOSE) != 0) {
     printf("Path");
-    if (randomize) printf("(random) :");
+    if (reproducible) printf("(reproducible) :");
+    else if (randomize) printf("(random) :");
+    else if (toBeSaved && p->planTruncated) printf("(measured, budget exhausted) :");
     else if (toBeSaved) printf("(measured) :");
+    else if (p->asyncPending) printf("(estimated, measuring in background) :");
     else printf("(estimated) :");
 
     for(int j = p->log2len;j >= 0;j--) if (p->bestPath[j] != 0) printf("%d(%s) ", p->bestPath[j], configStr[p->bestPathConfig[j]]);
     printf("\n");
   }
 
-  if (toBeSaved) {
-    PlanManager_saveMeasurementResultsP(p, (p->mode & SLEEF_MODE_NO_MT) != 0 ? 1 : 0);
+  // Incomplete measurements are not saved so that they can be improved later
+  if (toBeSaved && !p->planTruncated) {
+    PlanManager_saveMeasurementResultsP(p, pathCategory(p));
   }
   
   return 1;
@@ -1082,25 +1473,32 @@ static void measureTranspose(SleefDFT *p) {
   
   real *tBuf2 = (real *)Sleef_malloc(sizeof(real)*2*p->hlen*p->vlen);
 
-  const int niter =  1 + 5000000 / (p->hlen * p->vlen + 1);
+  const int niter =  1 + 5000000 / (p->hlen * p->vlen + 1) * effortNIterX4[planEffort(p)] / 4;
   uint64_t tm;
 
-  tm = Sleef_currentTimeMicros();
+  tm = Sleef_readCycleCounter();
   for(int i=0;i<niter;i++) {
     transpose(tBuf2, p->tBuf, p->log2hlen, p->log2vlen);
     transpose(tBuf2, p->tBuf, p->log2vlen, p->log2hlen);
   }
-  p->tmNoMT = Sleef_currentTimeMicros() - tm + 1;
+  p->tmNoMT = Sleef_readCycleCounter() - tm + 1;
 
   if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("transpose NoMT(measured): %lld\n", (long long int)p->tmNoMT);
 
+  if (planBudgetExhausted(p)) {
+    p->tmMT = p->log2hlen + p->log2vlen >= 14 ? p->tmNoMT / 2 : p->tmNoMT * 2;
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("transpose   MT(estimated): %lld\n", (long long int)p->tmMT);
+    Sleef_free(tBuf2);
+    return;
+  }
+
 #ifdef _OPENMP
-  tm = Sleef_currentTimeMicros();
+  tm = Sleef_readCycleCounter();
   for(int i=0;i<niter;i++) {
     transposeMT(tBuf2, p->tBuf, p->log2hlen, p->log2vlen);
     transposeMT(tBuf2, p->tBuf, p->log2vlen, p->log2hlen);
   }
-  p->tmMT = Sleef_currentTimeMicros() - tm + 1;
+  p->tmMT = Sleef_readCycleCounter() - tm + 1;
 
   if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("transpose   MT(measured): %lld\n", (long long int)p->tmMT);
 #else
@@ -1112,9 +1510,53 @@ static void measureTranspose(SleefDFT *p) {
   PlanManager_saveMeasurementResultsT(p);
 }
 
-// Implementation of SleefDFT_*_init1d
+// Asynchronous planning
+
+static void *asyncMeasure(void *arg) {
+  SleefDFT *p = (SleefDFT *)arg;
+
+  uint64_t mode = p->mode & ~(uint64_t)(SLEEF_MODE_ASYNC | SLEEF_MODE_CONVBITS | SLEEF_MODE_POSTBITS);
+  if ((mode & SLEEF_MODE_ALT) != 0) mode ^= SLEEF_MODE_BACKWARD;
+  uint32_t n = (mode & SLEEF_MODE_REAL) != 0 ? (2U << p->log2len) : (1U << p->log2len);
+
+  SleefDFT *q = INIT(n, NULL, NULL, mode);
+  if (q != NULL) atomicStorePtr((void **)&p->asyncPlan, q);
+
+  return NULL;
+}
+
+// Memory footprint of twiddle factor and permutation tables
+
+static uint64_t tableBytes1d(SleefDFT *p) {
+  const uint64_t n = UINT64_C(1) << p->log2len;
+  uint64_t z = p->log2len * sizeof(uint32_t) * (n + 8);
+  if ((p->mode & SLEEF_MODE_REAL) != 0) z += sizeof(real) * 2 * n;
+
+  for(int N=1;N<=MAXBUTWIDTH;N++) {
+    if (p->tbl[N] == NULL) continue;
+    for(uint32_t level=N;level<=p->log2len;level++) {
+      if (p->tbl[N][level] == NULL) continue;
+      z += sizeof(real) * ((uint64_t)constK[N] << (level-N)) * (level == p->log2len ? 2 : 1);
+    }
+  }
+
+  return z;
+}
+
+// Implementation of SleefDFT_*_init1d. The plan uses the given ISA
+// unless isa is -1.
+
+static SleefDFT *init1d(uint32_t n, const real *in, real *out, uint64_t mode, int isa) {
+  // The spectrum can be post-processed only if the output is complex
+  if ((mode & SLEEF_MODE_POSTBITS) != 0) {
+#ifdef HYPOT
+    if ((mode & SLEEF_MODE_POSTBITS) > SLEEF_MODE_PHASE || (mode & SLEEF_MODE_CONVBITS) != 0 ||
+	((mode & SLEEF_MODE_REAL) != 0 && (mode & SLEEF_MODE_BACKWARD) != 0)) return NULL;
+#else
+    return NULL;
+#endif
+  }
 
-EXPORT SleefDFT *INIT(uint32_t n, const real *in, real *out, uint64_t mode) {
   SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
   p->magic = MAGIC;
   p->baseTypeID = BASETYPEID;
@@ -1128,6 +1570,8 @@ EXPORT SleefDFT *INIT(uint32_t n, const real *in, real *out, uint64_t mode) {
   if ((p->mode & SLEEF_MODE_NO_MT) == 0) {
     p->mode2 |= SLEEF_MODE2_MT1D;
   }
+
+  if ((mode & SLEEF_MODE_TIMEBUDGETBITS) != 0) p->planDeadline = Sleef_currentTimeMicros() + (mode >> 32) * 1000;
   
   if ((mode & SLEEF_MODE_REAL) != 0) n /= 2;
   p->log2len = ilog2(n);
@@ -1146,9 +1590,13 @@ EXPORT SleefDFT *INIT(uint32_t n, const real *in, real *out, uint64_t mode) {
   // ISA availability
 
   int bestPriority = -1;
-  p->isa = -1;
+  p->isa = isa;
+
+  // In SLEEF_MODE_REPRODUCIBLE, only the first ISA is used so that the
+  // vector width does not depend on the computer
+  const int nISA = isa != -1 ? 0 : (mode & SLEEF_MODE_REPRODUCIBLE) != 0 ? 1 : ISAMAX;
 
-  for(int i=0;i<ISAMAX;i++) {
+  for(int i=0;i<nISA;i++) {
     if (checkISAAvailability(i) && bestPriority < (*GETINT[i])(GETINT_DFTPRIORITY) && n >= (uint32_t)((*GETINT[i])(GETINT_VECWIDTH) * (*GETINT[i])(GETINT_VECWIDTH))) {
       bestPriority = (*GETINT[i])(GETINT_DFTPRIORITY);
       p->isa = i;
@@ -1176,6 +1624,12 @@ EXPORT SleefDFT *INIT(uint32_t n, const real *in, real *out, uint64_t mode) {
     p->x0[i] = (real *)Sleef_malloc(sizeof(real) * 2 * n);
     p->x1[i] = (real *)Sleef_malloc(sizeof(real) * 2 * n);
   }
+
+  if ((mode & SLEEF_MODE_CONVBITS) != 0 && !convertsInStages(mode, p->log2len)) {
+    p->nHBuf = p->nThread;
+    p->hBuf = malloc(sizeof(real *) * p->nHBuf);
+    for(int i=0;i<p->nHBuf;i++) p->hBuf[i] = (real *)Sleef_malloc(sizeof(real) * (2 * n + 2));
+  }
   
   if ((mode & SLEEF_MODE_REAL) != 0) {
     p->rtCoef0 = (real *)Sleef_malloc(sizeof(real) * n);
@@ -1251,14 +1705,54 @@ EXPORT SleefDFT *INIT(uint32_t n, const real *in, real *out, uint64_t mode) {
     level -= N;
   }  
   
-  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("ISA : %s %d bit %s\n", (char *)(*GETPTR[p->isa])(0), (int)(GETINT[p->isa](GETINT_VECWIDTH) * sizeof(real) * 16), BASETYPESTRING);
+  p->isaName = (const char *)(*GETPTR[p->isa])(0);
+  p->vectorBits = (int)(GETINT[p->isa](GETINT_VECWIDTH) * sizeof(real) * 16);
+  p->tableBytes = tableBytes1d(p);
+  p->scratchBytes = (uint64_t)p->nThread * sizeof(real) * 4 * n + (uint64_t)p->nHBuf * sizeof(real) * (2 * n + 2);
+
+  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("ISA : %s %d bit %s\n", p->isaName, p->vectorBits, BASETYPESTRING);
+
+  if ((p->mode & SLEEF_MODE_REALTIME) != 0) {
+    // All tables and scratch buffers are faulted in and locked, so
+    // that no page fault happens while executing the transform
+    for(int level = p->log2len;level >= 1;level--) RealtimeMemory_lock(p, p->perm[level], sizeof(uint32_t) * ((1 << p->log2len) + 8));
+    for(int N=1;N<=MAXBUTWIDTH;N++) {
+      if (p->tbl[N] == NULL) continue;
+      for(uint32_t level=N;level<=p->log2len;level++) {
+	if (p->tbl[N][level] == NULL) continue;
+	RealtimeMemory_lock(p, p->tbl[N][level], sizeof(real) * ((uint64_t)constK[N] << (level-N)) * (level == p->log2len ? 2 : 1));
+      }
+    }
+    for(int i=0;i<p->nThread;i++) {
+      RealtimeMemory_lock(p, p->x0[i], sizeof(real) * 2 * n);
+      RealtimeMemory_lock(p, p->x1[i], sizeof(real) * 2 * n);
+    }
+    for(int i=0;i<p->nHBuf;i++) RealtimeMemory_lock(p, p->hBuf[i], sizeof(real) * (2 * n + 2));
+    if ((p->mode & SLEEF_MODE_REAL) != 0) {
+      RealtimeMemory_lock(p, p->rtCoef0, sizeof(real) * n);
+      RealtimeMemory_lock(p, p->rtCoef1, sizeof(real) * n);
+    }
+
+    if ((p->mode2 & SLEEF_MODE2_MT1D) != 0) {
+      RealtimeThreads_pin(p);
+      startAllThreads(p->nThread);
+    }
+  }
+
+  if (p->asyncPending) p->asyncThread = BackgroundThread_start(asyncMeasure, p);
 
   return p;
 }
 
+EXPORT SleefDFT *INIT(uint32_t n, const real *in, real *out, uint64_t mode) {
+  return init1d(n, in, out, mode, -1);
+}
+
 // Implementation of SleefDFT_*_init2d
 
 EXPORT SleefDFT *INIT2D(uint32_t vlen, uint32_t hlen, const real *in, real *out, uint64_t mode) {
+  if ((mode & SLEEF_MODE_POSTBITS) != 0) return NULL;
+
   SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
   p->magic = MAGIC2D;
   p->mode = mode;
@@ -1270,71 +1764,207 @@ EXPORT SleefDFT *INIT2D(uint32_t vlen, uint32_t hlen, const real *in, real *out,
   p->vlen = vlen;
   p->log2vlen = ilog2(vlen);
   
-  uint64_t mode1D = mode;
+  // The counters of 2D plans are kept by the row and column plans
+  uint64_t mode1D = mode & ~(SLEEF_MODE_TIMEBUDGETBITS | SLEEF_MODE_CONVBITS);
   mode1D |= SLEEF_MODE_NO_MT;
 
   if ((mode & SLEEF_MODE_NO_MT) == 0) p->mode3 |= SLEEF_MODE3_MT2D;
+
+  // The time budget is shared among row, column and transpose planning
+  const uint64_t budget = mode >> 32;
+  if (budget != 0) p->planDeadline = Sleef_currentTimeMicros() + budget * 1000;
   
-  p->instH = p->instV = INIT(hlen, NULL, NULL, mode1D);
-  if (hlen != vlen) p->instV = INIT(vlen, NULL, NULL, mode1D);
+  p->instH = p->instV = INIT(hlen, NULL, NULL, mode1D | SLEEF_MODE_TIMEBUDGET(budget == 0 ? 0 : MAX(budget / 3, 1)));
+  if (hlen != vlen) {
+    uint64_t remain = p->planDeadline <= Sleef_currentTimeMicros() ? 1 : (p->planDeadline - Sleef_currentTimeMicros()) / 2000;
+    p->instV = INIT(vlen, NULL, NULL, mode1D | SLEEF_MODE_TIMEBUDGET(budget == 0 ? 0 : MAX(remain, 1)));
+  }
 
-  p->tBuf = (void *)Sleef_malloc(sizeof(real)*2*hlen*vlen);
+  p->tBufBytes = sizeof(real)*2*hlen*vlen;
+  p->tBuf = (void *)Sleef_malloc(p->tBufBytes);
+
+  if ((mode & SLEEF_MODE_CONVBITS) != 0) {
+    p->nHBuf = 1;
+    p->hBuf = malloc(sizeof(real *));
+    p->hBuf[0] = (real *)Sleef_malloc(sizeof(real)*2*hlen*vlen);
+  }
 
   measureTranspose(p);
+
+  if ((mode & SLEEF_MODE_REALTIME) != 0) {
+    RealtimeMemory_lock(p, p->tBuf, sizeof(real)*2*hlen*vlen);
+    if (p->nHBuf != 0) RealtimeMemory_lock(p, p->hBuf[0], sizeof(real)*2*hlen*vlen);
+    if ((p->mode3 & SLEEF_MODE3_MT2D) != 0) RealtimeThreads_pin(p);
+  }
   
   return p;
 }
 
 // Implementation of SleefDFT_*_execute
 
-EXPORT void EXECUTE(SleefDFT *p, const real *s0, real *d0) {
-  assert(p != NULL && (p->magic == MAGIC || p->magic == MAGIC2D));
+#ifdef INITPRUNED
+static void executePruned(SleefDFT *p, const real *s, real *d);
+#endif
 
-  const real *s = s0 == NULL ? p->in : s0;
-  real *d = d0 == NULL ? p->out : d0;
+#ifdef INITBATCH
+static void executeBatch(SleefDFT *p, const real *s, real *d);
+#endif
 
-  if (p->magic == MAGIC2D) {
-  // S -> T -> D -> T -> D
+#ifdef INITGRAPH
+static void executeGraph(SleefDFT *p);
+#endif
 
-    real *tBuf = (real *)(p->tBuf);
+#ifdef INIT2DBATCH
+static void executeBatch2D(SleefDFT *p, const real *s, real *d);
+#endif
 
-#ifdef _OPENMP
-    if ((p->mode3 & SLEEF_MODE3_MT2D) != 0 &&
-	(((p->mode & SLEEF_MODE_DEBUG) == 0 && p->tmMT < p->tmNoMT) ||
-	 ((p->mode & SLEEF_MODE_DEBUG) != 0 && (rand() & 1))))
-      {
-	int y=0;
-#pragma omp parallel for
-	for(y=0;y<p->vlen;y++) {
-	  EXECUTE(p->instH, &s[p->hlen*2*y], &tBuf[p->hlen*2*y]);
-	}
+static void execute1d(SleefDFT *p, const real *s, real *d);
+static void executeStages(SleefDFT *p, const void *s0, void *d0, const int convIn, const int convOut, const real scale);
+#ifdef CONVMAX
+static void executeConv(SleefDFT *p, const void *s, void *d, int convIn, int convOut, real scale);
+#endif
 
-	transposeMT(d, tBuf, p->log2vlen, p->log2hlen);
+// S -> T -> D -> T -> D in one thread, with the transposition buffer T
+static void execute2dST(SleefDFT *p, const real *s, real *d, real *tBuf) {
+  for(int y=0;y<p->vlen;y++) {
+    EXECUTE(p->instH, &s[p->hlen*2*y], &tBuf[p->hlen*2*y]);
+  }
 
-#pragma omp parallel for
-	for(y=0;y<p->hlen;y++) {
-	  EXECUTE(p->instV, &d[p->vlen*2*y], &tBuf[p->vlen*2*y]);
-	}
+  transpose(d, tBuf, p->log2vlen, p->log2hlen);
 
-	transposeMT(d, tBuf, p->log2hlen, p->log2vlen);
-      } else
-#endif
-      {
-	for(int y=0;y<p->vlen;y++) {
-	  EXECUTE(p->instH, &s[p->hlen*2*y], &tBuf[p->hlen*2*y]);
-	}
+  for(int y=0;y<p->hlen;y++) {
+    EXECUTE(p->instV, &d[p->vlen*2*y], &tBuf[p->vlen*2*y]);
+  }
 
-	transpose(d, tBuf, p->log2vlen, p->log2hlen);
+  transpose(d, tBuf, p->log2hlen, p->log2vlen);
+}
 
-	for(int y=0;y<p->hlen;y++) {
-	  EXECUTE(p->instV, &d[p->vlen*2*y], &tBuf[p->vlen*2*y]);
-	}
+#ifdef HYPOT
+// The spectrum is replaced by the power, the magnitude, the power in
+// decibels or the phase of each bin, which are stored contiguously
+// from the beginning of the output. The last stage computes them with
+// the vector functions in libsleef if convertsInStages() holds.
+// Otherwise, they are computed in place after the transform.
+
+static INLINE real postValue(uint64_t post, real re, real im) {
+  switch(post) {
+  case SLEEF_MODE_POWER: return re * re + im * im;
+  case SLEEF_MODE_MAGNITUDE: return HYPOT(re, im);
+  case SLEEF_MODE_POWERDB: return 10 * LOG10(re * re + im * im);
+  default: return ATAN2(im, re);
+  }
+}
+
+static void postProcess(SleefDFT *p, real *d) {
+  const uint64_t post = p->mode & SLEEF_MODE_POSTBITS;
+  const int alt = (p->mode & SLEEF_MODE_REAL) != 0 && (p->mode & SLEEF_MODE_ALT) != 0;
+  const int nBin = (1 << p->log2len) + ((p->mode & SLEEF_MODE_REAL) != 0 && !alt);
+
+  // The real parts of the bins 0 and n/2 are at d[0] and d[1]
+  const real d1 = d[1];
+  if (alt) d[1] = 0;
+
+  if (p->log2len <= 1) {
+    // No ISA is chosen for these sizes
+    for(int k=0;k<nBin;k++) d[k] = postValue(post, d[k*2+0], d[k*2+1]);
+  } else {
+    (*POSTINPLACEX[convIndex(p->mode)][p->isa])(d, nBin);
+  }
+
+  if (alt) d[nBin] = postValue(post, d1, 0);
+}
+#endif // #ifdef HYPOT
+
+EXPORT void EXECUTE(SleefDFT *p, const real *s0, real *d0) {
+#ifdef INITPRUNED
+  if (p != NULL && p->magic == MAGICPRUNED) {
+    executePruned(p, s0 == NULL ? p->in : s0, d0 == NULL ? p->out : d0);
+    return;
+  }
+#endif
+
+#ifdef INITBATCH
+  if (p != NULL && p->magic == MAGICBATCH) {
+    executeBatch(p, s0 == NULL ? p->in : s0, d0 == NULL ? p->out : d0);
+    return;
+  }
+#endif
+
+#ifdef INITGRAPH
+  if (p != NULL && p->magic == MAGICGRAPH) {
+    executeGraph(p);
+    return;
+  }
+#endif
+
+#ifdef INIT2DBATCH
+  if (p != NULL && p->magic == MAGIC2DBATCH) {
+    executeBatch2D(p, s0 == NULL ? p->in : s0, d0 == NULL ? p->out : d0);
+    return;
+  }
+#endif
+
+  assert(p != NULL && (p->magic == MAGIC || p->magic == MAGIC2D));
+
+  const real *s = s0 == NULL ? p->in : s0;
+  real *d = d0 == NULL ? p->out : d0;
 
-	transpose(d, tBuf, p->log2hlen, p->log2vlen);
+  if (p->magic == MAGIC2D) {
+  // S -> T -> D -> T -> D
+
+    real *tBuf = (real *)(p->tBuf);
+
+#ifdef _OPENMP
+    if ((p->mode3 & SLEEF_MODE3_MT2D) != 0 &&
+	(((p->mode & SLEEF_MODE_DEBUG) == 0 && p->tmMT < p->tmNoMT) ||
+	 ((p->mode & SLEEF_MODE_DEBUG) != 0 && (rand() & 1))))
+      {
+	int y=0;
+#pragma omp parallel for
+	for(y=0;y<p->vlen;y++) {
+	  EXECUTE(p->instH, &s[p->hlen*2*y], &tBuf[p->hlen*2*y]);
+	}
+
+	transposeMT(d, tBuf, p->log2vlen, p->log2hlen);
+
+#pragma omp parallel for
+	for(y=0;y<p->hlen;y++) {
+	  EXECUTE(p->instV, &d[p->vlen*2*y], &tBuf[p->vlen*2*y]);
+	}
+
+	transposeMT(d, tBuf, p->log2hlen, p->log2vlen);
+      } else
+#endif
+      {
+	execute2dST(p, s, d, tBuf);
       }
 
     return;
   }
+
+#ifdef CONVMAX
+  if ((p->mode & SLEEF_MODE_POSTBITS) != 0 && convertsInStages(p->mode, p->log2len)) {
+    executeConv(p, s, d, CONV_NONE, convIndex(p->mode), 1);
+    return;
+  }
+#endif
+
+  execute1d(p, s, d);
+
+#ifdef HYPOT
+  if ((p->mode & SLEEF_MODE_POSTBITS) != 0) postProcess(p, d);
+#endif
+}
+
+static void execute1d(SleefDFT *p, const real *s, real *d) {
+  if (p->asyncThread != NULL) {
+    // The measured plan is used once the background thread has published it
+    SleefDFT *q = (SleefDFT *)atomicLoadPtr((void **)&p->asyncPlan);
+    if (q != NULL) {
+      EXECUTE(q, s, d);
+      return;
+    }
+  }
   
   if (p->log2len <= 1) {
     if ((p->mode & SLEEF_MODE_REAL) == 0) {
@@ -1396,14 +2026,27 @@ EXPORT void EXECUTE(SleefDFT *p, const real *s0, real *d0) {
     return;
   }
 
-  //
+  executeStages(p, s, d, CONV_NONE, CONV_NONE, 1);
+}
+
+// The input or the output in another format is converted by the first
+// or the last stage, and is not accessed as real. The scratch buffers
+// are used instead of the output buffer in the middle stages then.
+
+static void executeStages(SleefDFT *p, const void *s0, void *d0, const int convIn, const int convOut, const real scale) {
+  const real *s = (const real *)s0;
+  real *d = (real *)d0;
 
 #ifdef _OPENMP
   const int tn = omp_get_thread_num();
-  real *t[] = { p->x1[tn], p->x0[tn], d };
 #else
-  real *t[] = { p->x1[0], p->x0[0], d };
+  const int tn = 0;
 #endif
+
+  // A buffer given by the user that is not aligned to vectors is only
+  // accessed by the first or the last stage, with unaligned loads and stores
+  const int sAligned = convIn == CONV_NONE && isAligned(p, s), dAligned = convOut == CONV_NONE && isAligned(p, d);
+  real *t[] = { p->x1[tn], p->x0[tn], dAligned ? d : p->x1[tn] };
   
   const real *lb = s;
   int nb = 0;
@@ -1412,30 +2055,1173 @@ EXPORT void EXECUTE(SleefDFT *p, const real *s0, real *d0) {
       ((p->mode & SLEEF_MODE_BACKWARD) != 0) != ((p->mode & SLEEF_MODE_ALT) != 0)) nb = -1;
   if ((p->mode & SLEEF_MODE_REAL) == 0 && (p->pathLen & 1) == 1) nb = -1;
   
+  const int counting = (p->mode & SLEEF_MODE_COUNTERS) != 0;
+  uint64_t tm = counting ? Sleef_readCycleCounter() : 0;
+
   if ((p->mode & SLEEF_MODE_REAL) != 0 &&
       ((p->mode & SLEEF_MODE_BACKWARD) != 0) != ((p->mode & SLEEF_MODE_ALT) != 0)) {
-    (*REALSUB1[p->isa])(t[nb+1], s, p->log2len, p->rtCoef0, p->rtCoef1, (p->mode & SLEEF_MODE_ALT) == 0);
-    if ((p-> mode & SLEEF_MODE_ALT) == 0) t[nb+1][(1 << p->log2len)+1] = -s[(1 << p->log2len)+1] * 2;
+#ifdef CONVMAX
+    if (convIn != CONV_NONE) {
+      (*REALSUB1X[convIn][p->isa])(t[nb+1], s, p->log2len, p->rtCoef0, p->rtCoef1, (p->mode & SLEEF_MODE_ALT) == 0, scale);
+    } else
+#endif
+    {
+      (*(sAligned ? REALSUB1 : REALSUB1U)[p->isa])(t[nb+1], s, p->log2len, p->rtCoef0, p->rtCoef1, (p->mode & SLEEF_MODE_ALT) == 0);
+      if ((p-> mode & SLEEF_MODE_ALT) == 0) t[nb+1][(1 << p->log2len)+1] = -s[(1 << p->log2len)+1] * 2;
+    }
     lb = t[nb+1];
     nb = (nb + 1) & 1;
+    if (counting) {
+      uint64_t tm1 = Sleef_readCycleCounter();
+      atomicAddU64(&p->stageTicks[p->pathLen], tm1 - tm);
+      atomicAddU64(&p->stageCalls[p->pathLen], 1);
+      tm = tm1;
+    }
   }
 
-  for(int level = p->log2len;level >= 1;) {
+  const int realPost = (p->mode & SLEEF_MODE_REAL) != 0 &&
+    ((p->mode & SLEEF_MODE_BACKWARD) == 0) != ((p->mode & SLEEF_MODE_ALT) != 0);
+
+  for(int level = p->log2len, j=0;level >= 1;j++) {
     int N = ABS(p->bestPath[level]), config = p->bestPathConfig[level];
-    dispatch(p, N, t[nb+1], lb, level, config);
+    real *out = level == N && !realPost ? d : t[nb+1];
+#ifdef CONVMAX
+    if (lb == s && convIn != CONV_NONE) {
+      dispatchConvIn(p, N, out, s, level, config, convIn, scale);
+    } else if (out == d && convOut != CONV_NONE) {
+      dispatchConvOut(p, N, d, lb, level, config, convOut, scale);
+    } else
+#endif
+    {
+      dispatch(p, N, out, lb, level, config, (lb == s && !sAligned) || (out == d && !dAligned));
+    }
     level -= N;
     lb = t[nb+1];
     nb = (nb + 1) & 1;
+    if (counting) {
+      uint64_t tm1 = Sleef_readCycleCounter();
+      atomicAddU64(&p->stageTicks[j], tm1 - tm);
+      atomicAddU64(&p->stageCalls[j], 1);
+      tm = tm1;
+    }
+  }
+
+  if (realPost) {
+#ifdef CONVMAX
+    if (convOut != CONV_NONE) {
+      (*REALSUB0X[convOut][p->isa])(d, lb, p->log2len, p->rtCoef0, p->rtCoef1, (p->mode & SLEEF_MODE_ALT) == 0, scale);
+    } else
+#endif
+    {
+      (*(dAligned ? REALSUB0 : REALSUB0U)[p->isa])(d, lb, p->log2len, p->rtCoef0, p->rtCoef1);
+      if ((p->mode & SLEEF_MODE_ALT) == 0) {
+	d[(1 << p->log2len)+1] = -d[(1 << p->log2len)+1];
+	d[(2 << p->log2len)+0] =  d[1];
+	d[(2 << p->log2len)+1] =  0;
+	d[1] = 0;
+      }
+    }
+    if (counting) {
+      atomicAddU64(&p->stageTicks[p->pathLen], Sleef_readCycleCounter() - tm);
+      atomicAddU64(&p->stageCalls[p->pathLen], 1);
+    }
+  }
+}
+
+#if defined(EXECUTE16) || defined(EXECUTEINT)
+// Transforms with input or output in other formats. The data is
+// converted by the first and the last stages if convertsInStages()
+// holds. Otherwise, the data in the base type is kept in a staging
+// buffer held by the plan.
+
+static void executeConv(SleefDFT *p, const void *s, void *d, int convIn, int convOut, real scale) {
+  // The measured plan is used once the background thread has published it
+  SleefDFT *q = p->asyncThread != NULL ? (SleefDFT *)atomicLoadPtr((void **)&p->asyncPlan) : NULL;
+  executeStages(q != NULL ? q : p, s, d, convIn, convOut, scale);
+}
+
+static void convLength(SleefDFT *p, int *nIn, int *nOut) {
+  if (p->magic == MAGIC2D) {
+    *nIn = *nOut = p->hlen*p->vlen*2;
+    return;
+  }
+
+  *nIn = *nOut = 2 << p->log2len;
+  if ((p->mode & SLEEF_MODE_REAL) != 0 && (p->mode & SLEEF_MODE_ALT) == 0) {
+    if ((p->mode & SLEEF_MODE_BACKWARD) == 0) *nOut += 2; else *nIn += 2;
+  }
+}
+
+static real *stagingBuffer(SleefDFT *p, real *sbuf) {
+  if (p->magic == MAGIC2D) return (real *)p->hBuf[0];
+  if (p->log2len <= 1) return sbuf;
+#ifdef _OPENMP
+  return (real *)p->hBuf[omp_get_thread_num()];
+#else
+  return (real *)p->hBuf[0];
+#endif
+}
+#endif // #if defined(EXECUTE16) || defined(EXECUTEINT)
+
+#ifdef EXECUTE16
+// Transforms with 16-bit floating point input and output
+
+static void expand16(real *d, const uint16_t *s, int n, int bf16) {
+  if (bf16) {
+    for(int i=0;i<n;i++) d[i] = fromBF16(s[i]);
+  } else {
+    for(int i=0;i<n;i++) d[i] = fromFP16(s[i]);
+  }
+}
+
+static void narrow16(uint16_t *d, const real *s, int n, int bf16) {
+  if (bf16) {
+    for(int i=0;i<n;i++) d[i] = toBF16(s[i]);
+  } else {
+    for(int i=0;i<n;i++) d[i] = toFP16(s[i]);
+  }
+}
+
+// Shorter transforms and 2D transforms widen the data, transform it in
+// place and narrow it into the output
+
+EXPORT void EXECUTE16(SleefDFT *p, const uint16_t *s0, uint16_t *d0) {
+  assert(p != NULL && (p->magic == MAGIC || p->magic == MAGIC2D));
+  assert((p->mode & (SLEEF_MODE_FP16 | SLEEF_MODE_BF16)) != 0);
+
+  const uint16_t *s = s0 == NULL ? (const uint16_t *)p->in : s0;
+  uint16_t *d = d0 == NULL ? (uint16_t *)p->out : d0;
+  const int bf16 = (p->mode & SLEEF_MODE_BF16) != 0;
+
+  if (p->magic == MAGIC && convertsInStages(p->mode, p->log2len)) {
+    executeConv(p, s, d, convIndex(p->mode), convIndex(p->mode), 1);
+    return;
+  }
+
+  int nIn, nOut;
+  convLength(p, &nIn, &nOut);
+
+  real sbuf[8];
+  real *h = stagingBuffer(p, sbuf);
+
+  expand16(h, s, nIn, bf16);
+  EXECUTE(p, h, h);
+  narrow16(d, h, nOut, bf16);
+}
+#endif // #ifdef EXECUTE16
+
+#ifdef EXECUTEINT
+// Transforms with integer samples in the time domain
+
+static void expandInt(real *d, const void *s, int n, real scale, int int16) {
+  if (int16) {
+    const int16_t *s16 = (const int16_t *)s;
+    for(int i=0;i<n;i++) d[i] = s16[i] * scale;
+  } else {
+    const int32_t *s32 = (const int32_t *)s;
+    for(int i=0;i<n;i++) d[i] = s32[i] * scale;
+  }
+}
+
+// Values are rounded to nearest and saturated. NaN is converted to 0.
+
+static void narrowInt(void *d, const real *s, int n, real scale, int int16) {
+  if (int16) {
+    int16_t *d16 = (int16_t *)d;
+    for(int i=0;i<n;i++) d16[i] = toInt16(s[i] * scale);
+  } else {
+    int32_t *d32 = (int32_t *)d;
+    for(int i=0;i<n;i++) d32[i] = toInt32(s[i] * scale);
+  }
+}
+
+// The integer samples are the input of a forward transform and the
+// output of a backward transform. They are multiplied by scale.
+
+EXPORT void EXECUTEINT(SleefDFT *p, const void *s0, void *d0, real scale) {
+  assert(p != NULL && (p->magic == MAGIC || p->magic == MAGIC2D));
+  assert((p->mode & (SLEEF_MODE_INT16 | SLEEF_MODE_INT32)) != 0);
+
+  const void *s = s0 == NULL ? p->in : s0;
+  void *d = d0 == NULL ? p->out : d0;
+  const int int16 = (p->mode & SLEEF_MODE_INT16) != 0;
+
+  int backward = (p->mode & SLEEF_MODE_BACKWARD) != 0;
+  if (p->magic == MAGIC && (p->mode & SLEEF_MODE_ALT) != 0) backward = !backward;
+
+  if (p->magic == MAGIC && convertsInStages(p->mode, p->log2len)) {
+    if (!backward) {
+      executeConv(p, s, d, convIndex(p->mode), CONV_NONE, scale);
+    } else {
+      executeConv(p, s, d, CONV_NONE, convIndex(p->mode), scale);
+    }
+    return;
+  }
+
+  int nIn, nOut;
+  convLength(p, &nIn, &nOut);
+
+  real sbuf[8];
+  real *h = stagingBuffer(p, sbuf);
+
+  if (!backward) {
+    expandInt(h, s, nIn, scale, int16);
+    EXECUTE(p, h, (real *)d);
+  } else {
+    EXECUTE(p, (const real *)s, h);
+    narrowInt(d, h, nOut, scale, int16);
+  }
+}
+#endif // #ifdef EXECUTEINT
+
+#ifdef EXECUTESTREAM
+// Streaming execution. The blocks are transformed in groups of one
+// block per thread, with two groups of input and output buffers. While
+// a group is transformed, the last thread writes back the previous group
+// and reads the next one, then joins the computation.
+
+static uint32_t streamRead(real *buf, uint64_t first, uint32_t cnt, uint64_t len, SleefDFT_readFunc readFunc, void *ctx) {
+  for(uint32_t i=0;i<cnt;i++) {
+    if ((*readFunc)(ctx, SLEEF_OOC_INPUT, (first + i) * len * sizeof(real), &buf[i * len], len * sizeof(real)) != 0) return i;
+  }
+  return cnt;
+}
+
+static int streamWrite(const real *buf, uint64_t first, uint32_t cnt, uint64_t len, uint64_t outLen, SleefDFT_writeFunc writeFunc, void *ctx) {
+  for(uint32_t i=0;i<cnt;i++) {
+    if ((*writeFunc)(ctx, (first + i) * outLen * sizeof(real), &buf[i * len], outLen * sizeof(real)) != 0) return -1;
+  }
+  return 0;
+}
+
+EXPORT int64_t EXECUTESTREAM(SleefDFT *p, uint64_t nBlocks, SleefDFT_readFunc readFunc, SleefDFT_writeFunc writeFunc, void *ctx) {
+  assert(p != NULL && p->magic == MAGIC);
+
+  int nIn, nOut;
+  convLength(p, &nIn, &nOut);
+
+  // Only the values of the bins are written if the spectrum is post-processed
+  uint64_t outLen = nOut;
+  if ((p->mode & SLEEF_MODE_POSTBITS) != 0) outLen = (1 << p->log2len) + ((p->mode & SLEEF_MODE_REAL) != 0 ? 1 : 0);
+
+#ifdef _OPENMP
+  // The threads beyond the scratch buffers of the plan only do I/O
+  const int nth = (p->mode & SLEEF_MODE_NO_MT) != 0 ? 2 : MAX(2, omp_thread_count());
+  const int nCompute = p->log2len <= 1 ? nth : p->nThread;
+  const uint32_t G = (p->mode & SLEEF_MODE_NO_MT) != 0 ? 1 : nth - 1;
+#else
+  const uint32_t G = 1;
+#endif
+
+  real *inBuf[2], *outBuf[2];
+  for(int i=0;i<2;i++) {
+    inBuf[i]  = (real *)Sleef_malloc(sizeof(real) * nIn * G);
+    outBuf[i] = (real *)Sleef_malloc(sizeof(real) * nOut * G);
+  }
+
+#define GROUPLEN(first) (nBlocks == 0 ? G : (uint32_t)MIN((uint64_t)G, nBlocks - (first)))
+
+  int err = 0;
+  uint64_t first = 0, nWritten = 0;
+  uint32_t cnt = streamRead(inBuf[0], 0, GROUPLEN(0), nIn, readFunc, ctx), prevCnt = 0;
+
+  for(uint64_t g=0;cnt > 0 && err == 0;g++, first += G) {
+    const real *in = inBuf[g & 1];
+    real *out = outBuf[g & 1];
+    uint32_t nextCnt = 0;
+    const int more = cnt == G && (nBlocks == 0 || first + G < nBlocks);
+
+#ifdef _OPENMP
+    int64_t next = 0;
+#pragma omp parallel num_threads(nth)
+    {
+      const int tn = omp_get_thread_num();
+      if (tn == omp_get_num_threads() - 1) {
+	if (g > 0 && streamWrite(outBuf[(g-1) & 1], first - G, prevCnt, nOut, outLen, writeFunc, ctx) != 0) err = -1;
+	if (more) nextCnt = streamRead(inBuf[(g+1) & 1], first + G, GROUPLEN(first + G), nIn, readFunc, ctx);
+      }
+      if (tn < nCompute) {
+	for(;;) {
+	  int64_t i;
+#pragma omp atomic capture
+	  i = next++;
+	  if (i >= (int64_t)cnt) break;
+	  EXECUTE(p, &in[i * nIn], &out[i * nOut]);
+	}
+      }
+    }
+#else
+    if (g > 0 && streamWrite(outBuf[(g-1) & 1], first - G, prevCnt, nOut, outLen, writeFunc, ctx) != 0) err = -1;
+    if (more) nextCnt = streamRead(inBuf[(g+1) & 1], first + G, GROUPLEN(first + G), nIn, readFunc, ctx);
+    for(uint32_t i=0;i<cnt;i++) EXECUTE(p, &in[i * nIn], &out[i * nOut]);
+#endif
+
+    if (g > 0 && err == 0) nWritten += prevCnt;
+    prevCnt = cnt;
+    cnt = nextCnt;
+
+    if (cnt == 0 && err == 0) {
+      if (streamWrite(out, first, prevCnt, nOut, outLen, writeFunc, ctx) != 0) err = -1; else nWritten += prevCnt;
+    }
+  }
+
+#undef GROUPLEN
+
+  for(int i=0;i<2;i++) {
+    Sleef_free(outBuf[i]);
+    Sleef_free(inBuf[i]);
+  }
+
+  return err != 0 ? -1 : (int64_t)nWritten;
+}
+#endif // #ifdef EXECUTESTREAM
+
+#ifdef INITPRUNED
+// Pruned transforms
+//
+// When only the first nIn inputs are non-zero, the n-point transform
+// is split into L = n/K transforms of K >= nIn points :
+//   X[L*s + r] = DFT_K(x[j] * w^(j*r))[s]
+// When only the first nOut outputs are needed, it is split into L
+// transforms of M >= nOut points of the decimated inputs :
+//   X[q] = sum_r w^(r*q) * DFT_M(x[L*t + r])[q]
+// The split that gives the shorter sub-transforms is chosen.
+
+EXPORT SleefDFT *INITPRUNED(uint32_t n, uint32_t nIn, uint32_t nOut, const real *in, real *out, uint64_t mode) {
+  if ((mode & SLEEF_MODE_REAL) != 0 || (mode & SLEEF_MODE_POSTBITS) != 0 || n < 4 || (n & (n-1)) != 0 ||
+      nIn == 0 || nIn > n || nOut == 0 || nOut > n) return NULL;
+
+  SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
+  p->magic = MAGICPRUNED;
+  p->mode = mode;
+  p->baseTypeID = BASETYPEID;
+  p->in = in;
+  p->out = out;
+  p->prLen = n;
+  p->prIn = nIn;
+  p->prOut = nOut;
+
+  int log2k = ilog2(nIn), log2m = ilog2(nOut);
+  if ((1U << log2k) < nIn) log2k++;
+  if ((1U << log2m) < nOut) log2m++;
+  log2k = MAX(log2k, 2);
+  log2m = MAX(log2m, 2);
+
+  p->prByInput = log2k <= log2m;
+  p->log2prSub = p->prByInput ? log2k : log2m;
+
+  const uint32_t sub = 1U << p->log2prSub;
+
+#ifdef _OPENMP
+  p->prNThread = (mode & SLEEF_MODE_NO_MT) != 0 ? 1 : omp_thread_count();
+#else
+  p->prNThread = 1;
+#endif
+
+  p->instPr = INIT(sub, NULL, NULL, (mode & ~(SLEEF_MODE_TIMEBUDGETBITS | SLEEF_MODE_CONVBITS)) | SLEEF_MODE_NO_MT);
+
+  if (p->instPr == NULL) {
+    p->magic = 0;
+    free(p);
+    return NULL;
+  }
+
+  // SLEEF_MODE_ALT reverses the direction of complex transforms
+  const int sign = ((mode & SLEEF_MODE_BACKWARD) != 0) != ((mode & SLEEF_MODE_ALT) != 0) ? 1 : -1;
+  real *tw = (real *)Sleef_malloc(sizeof(real) * 2 * n);
+
+  for(uint32_t i=0;i<n;i++) {
+    sc_t sc = SINCOSPI(sign * 2 * (real)i / n);
+    tw[i*2+0] = sc.y; tw[i*2+1] = sc.x;
+  }
+
+  p->prTw = tw;
+  p->prBuf = Sleef_malloc(sizeof(real) * ((p->prByInput ? 0 : 2 * (uint64_t)n) + (uint64_t)p->prNThread * 4 * sub));
+
+  if ((mode & SLEEF_MODE_VERBOSE) != 0) {
+    printf("Pruned : %u transforms of %u points for %s\n", n / sub, sub, p->prByInput ? "input" : "output");
+  }
+
+  return p;
+}
+
+static void executePrunedSub(SleefDFT *p, const real *s, real *d, uint32_t r, real *y, real *z) {
+  const uint32_t n = p->prLen, sub = 1U << p->log2prSub, L = n / sub;
+  const real *tw = (const real *)p->prTw;
+
+  if (p->prByInput) {
+    for(uint32_t j=0;j<sub;j++) {
+      if (j >= p->prIn) { y[j*2+0] = y[j*2+1] = 0; continue; }
+      const uint32_t t = (uint32_t)(((uint64_t)j * r) & (n-1));
+      y[j*2+0] = s[j*2+0] * tw[t*2+0] - s[j*2+1] * tw[t*2+1];
+      y[j*2+1] = s[j*2+0] * tw[t*2+1] + s[j*2+1] * tw[t*2+0];
+    }
+
+    EXECUTE(p->instPr, y, z);
+
+    for(uint32_t k=0;k<sub && L*k+r < p->prOut;k++) {
+      d[(L*k+r)*2+0] = z[k*2+0];
+      d[(L*k+r)*2+1] = z[k*2+1];
+    }
+  } else {
+    for(uint32_t t=0;t<sub;t++) {
+      const uint32_t j = L*t+r;
+      y[t*2+0] = j < p->prIn ? s[j*2+0] : 0;
+      y[t*2+1] = j < p->prIn ? s[j*2+1] : 0;
+    }
+
+    EXECUTE(p->instPr, y, d);
+  }
+}
+
+static void executePruned(SleefDFT *p, const real *s, real *d) {
+  const uint32_t n = p->prLen, sub = 1U << p->log2prSub, L = n / sub;
+  real *buf = (real *)p->prBuf;
+  real *zs = p->prByInput ? NULL : buf;
+  real *work = p->prByInput ? buf : buf + 2 * (uint64_t)n;
+
+  // Each sub-transform writes to disjoint elements of d, or to its own row of zs
+
+#ifdef _OPENMP
+  if (p->prNThread > 1) {
+    int r;
+#pragma omp parallel for
+    for(r=0;r<(int)L;r++) {
+      real *y = work + (uint64_t)omp_get_thread_num() * 4 * sub;
+      executePrunedSub(p, s, p->prByInput ? d : zs + (uint64_t)r * 2 * sub, r, y, y + 2 * sub);
+    }
+  } else
+#endif
+  {
+    for(uint32_t r=0;r<L;r++) {
+      executePrunedSub(p, s, p->prByInput ? d : zs + (uint64_t)r * 2 * sub, r, work, work + 2 * sub);
+    }
   }
 
-  if ((p->mode & SLEEF_MODE_REAL) != 0 && 
-      ((p->mode & SLEEF_MODE_BACKWARD) == 0) != ((p->mode & SLEEF_MODE_ALT) != 0)) {
-    (*REALSUB0[p->isa])(d, lb, p->log2len, p->rtCoef0, p->rtCoef1);
-    if ((p->mode & SLEEF_MODE_ALT) == 0) {
-      d[(1 << p->log2len)+1] = -d[(1 << p->log2len)+1];
-      d[(2 << p->log2len)+0] =  d[1];
-      d[(2 << p->log2len)+1] =  0;
-      d[1] = 0;
+  if (p->prByInput) return;
+
+  // Combine the sub-transforms of the decimated inputs
+
+  const real *tw = (const real *)p->prTw;
+  int q;
+#ifdef _OPENMP
+#pragma omp parallel for if (p->prNThread > 1)
+#endif
+  for(q=0;q<(int)p->prOut;q++) {
+    real re = 0, im = 0;
+    for(uint32_t r=0;r<L;r++) {
+      const uint32_t t = (uint32_t)(((uint64_t)r * q) & (n-1));
+      const real zr = zs[((uint64_t)r * sub + q)*2+0], zi = zs[((uint64_t)r * sub + q)*2+1];
+      re += zr * tw[t*2+0] - zi * tw[t*2+1];
+      im += zr * tw[t*2+1] + zi * tw[t*2+0];
     }
+    d[q*2+0] = re;
+    d[q*2+1] = im;
+  }
+}
+#endif // #ifdef INITPRUNED
+
+#ifdef INITBATCH
+// Batched real transforms
+//
+// Two real signals a and b are transformed together as one complex
+// signal z = a + i*b, and the spectra are separated with
+//   A[k] = (Z[k] + conj(Z[n-k])) / 2,  B[k] = (Z[k] - conj(Z[n-k])) / 2i
+// Backward transforms merge the two half spectra into Z = A + i*B
+// before the complex transform. Pairing is used when it is measured
+// to be faster than transforming each channel with the real transform.
+
+static void splitPair(real *RESTRICT a, real *RESTRICT b, const real *RESTRICT z, uint32_t n) {
+  a[0] = z[0]; a[1] = 0;
+  b[0] = z[1]; b[1] = 0;
+
+  for(uint32_t k=1;k<=n/2;k++) {
+    const real zr = z[k*2+0], zi = z[k*2+1], wr = z[(n-k)*2+0], wi = z[(n-k)*2+1];
+    a[k*2+0] = (zr + wr) * (real)0.5;
+    a[k*2+1] = (zi - wi) * (real)0.5;
+    b[k*2+0] = (zi + wi) * (real)0.5;
+    b[k*2+1] = (wr - zr) * (real)0.5;
+  }
+}
+
+static void mergePair(real *RESTRICT z, const real *RESTRICT a, const real *RESTRICT b, uint32_t n) {
+  // The imaginary parts of the DC and Nyquist terms are ignored,
+  // as with the real transform
+
+  z[0] = a[0]; z[1] = b[0];
+  z[n+0] = a[n]; z[n+1] = b[n];
+
+  for(uint32_t k=1;k<n/2;k++) {
+    const real ar = a[k*2+0], ai = a[k*2+1], br = b[k*2+0], bi = b[k*2+1];
+    z[k*2+0] = ar - bi;
+    z[k*2+1] = ai + br;
+    z[(n-k)*2+0] = ar + bi;
+    z[(n-k)*2+1] = br - ai;
   }
 }
+
+static void executeBatchPair(SleefDFT *p, const real *s, real *d, uint32_t c, real *y, real *z) {
+  const uint32_t n = p->btLen;
+
+  if ((p->mode & SLEEF_MODE_BACKWARD) == 0) {
+    const real *s0 = s + (uint64_t)c * n, *s1 = s0 + n;
+    for(uint32_t j=0;j<n;j++) {
+      y[j*2+0] = s0[j];
+      y[j*2+1] = s1[j];
+    }
+    EXECUTE(p->instBtC, y, z);
+    splitPair(d + (uint64_t)c * (n+2), d + (uint64_t)(c+1) * (n+2), z, n);
+  } else {
+    mergePair(y, s + (uint64_t)c * (n+2), s + (uint64_t)(c+1) * (n+2), n);
+    EXECUTE(p->instBtC, y, z);
+    real *d0 = d + (uint64_t)c * n, *d1 = d0 + n;
+    for(uint32_t j=0;j<n;j++) {
+      d0[j] = z[j*2+0];
+      d1[j] = z[j*2+1];
+    }
+  }
+}
+
+static void executeBatchSingle(SleefDFT *p, const real *s, real *d, uint32_t c) {
+  // Spectra take n+2 elements, or n elements with SLEEF_MODE_ALT
+
+  const uint32_t n = p->btLen, ns = (p->mode & SLEEF_MODE_ALT) == 0 ? n+2 : n;
+  const uint64_t is = (p->mode & SLEEF_MODE_BACKWARD) == 0 ? n : ns, os = (p->mode & SLEEF_MODE_BACKWARD) == 0 ? ns : n;
+  EXECUTE(p->instBtR, s + c * is, d + c * os);
+}
+
+static void measureBatch(SleefDFT *p) {
+  if (p->instBtC == NULL) {
+    p->btPaired = 0;
+    return;
+  }
+
+  if ((p->mode & SLEEF_MODE_MEASURE) == 0 && (!planFilePathSet || (p->mode & SLEEF_MODE_MEASUREBITS) != 0)) {
+    p->btPaired = 0;
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Batch : selected real(estimated)\n");
+    return;
+  }
+
+  const uint32_t n = p->btLen;
+  real *sBuf = (real *)Sleef_malloc(sizeof(real) * 2 * (n+2));
+  real *dBuf = (real *)Sleef_malloc(sizeof(real) * 2 * (n+2));
+  real *y = (real *)p->btBuf, *z = y + 2 * (uint64_t)n;
+
+  for(uint32_t i=0;i<2*(n+2);i++) sBuf[i] = (real)(i & 7) * (real)0.125;
+
+  const int niter = 1 + 5000000 / (2 * n + 1) * effortNIterX4[planEffort(p)] / 4;
+  uint64_t tm, tmPaired, tmSingle;
+
+  tm = Sleef_readCycleCounter();
+  for(int i=0;i<niter;i++) executeBatchPair(p, sBuf, dBuf, 0, y, z);
+  tmPaired = Sleef_readCycleCounter() - tm;
+
+  tm = Sleef_readCycleCounter();
+  for(int i=0;i<niter;i++) {
+    executeBatchSingle(p, sBuf, dBuf, 0);
+    executeBatchSingle(p, sBuf, dBuf, 1);
+  }
+  tmSingle = Sleef_readCycleCounter() - tm;
+
+  p->btPaired = tmPaired < tmSingle;
+
+  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) {
+    printf("Batch paired(measured): %lld\n", (long long int)tmPaired);
+    printf("Batch   real(measured): %lld\n", (long long int)tmSingle);
+  }
+
+  Sleef_free(sBuf);
+  Sleef_free(dBuf);
+}
+
+EXPORT SleefDFT *INITBATCH(uint32_t n, uint32_t batch, const real *in, real *out, uint64_t mode) {
+  if ((mode & SLEEF_MODE_REAL) == 0 || (mode & SLEEF_MODE_POSTBITS) != 0 || n < 4 || (n & (n-1)) != 0 || batch == 0) return NULL;
+
+  SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
+  p->magic = MAGICBATCH;
+  p->mode = mode;
+  p->baseTypeID = BASETYPEID;
+  p->in = in;
+  p->out = out;
+  p->btLen = n;
+  p->btCount = batch;
+
+#ifdef _OPENMP
+  p->btNThread = (mode & SLEEF_MODE_NO_MT) != 0 ? 1 : omp_thread_count();
+#else
+  p->btNThread = 1;
+#endif
+
+  const uint64_t mode1D = (mode & ~(SLEEF_MODE_TIMEBUDGETBITS | SLEEF_MODE_CONVBITS)) | SLEEF_MODE_NO_MT;
+
+  p->instBtR = INIT(n, NULL, NULL, mode1D);
+
+  // The spectra of the paired transform are split in the standard
+  // layout, so SLEEF_MODE_ALT always uses the real transform. The
+  // paired transform rounds differently, so it is not used in
+  // SLEEF_MODE_REPRODUCIBLE either.
+
+  const int pairable = batch >= 2 && (mode & (SLEEF_MODE_ALT | SLEEF_MODE_REPRODUCIBLE)) == 0;
+
+  if (pairable) {
+    p->instBtC = INIT(n, NULL, NULL, mode1D & ~(uint64_t)SLEEF_MODE_REAL);
+  }
+
+  if (p->instBtR == NULL || (pairable && p->instBtC == NULL)) {
+    if (p->instBtR != NULL) SleefDFT_dispose(p->instBtR);
+    if (p->instBtC != NULL) SleefDFT_dispose(p->instBtC);
+    p->magic = 0;
+    free(p);
+    return NULL;
+  }
+
+  if (p->instBtC != NULL) p->btBuf = Sleef_malloc(sizeof(real) * (uint64_t)p->btNThread * 4 * n);
+
+  measureBatch(p);
+
+  if ((mode & SLEEF_MODE_VERBOSE) != 0) {
+    printf("Batch : %u transforms of %u points, %s\n", batch, n, p->btPaired ? "paired" : "real");
+  }
+
+  return p;
+}
+
+static void executeBatch(SleefDFT *p, const real *s, real *d) {
+  const int paired = p->instBtC != NULL && ((p->mode & SLEEF_MODE_DEBUG) == 0 ? p->btPaired : (rand() & 1));
+  const uint32_t n = p->btLen, nPair = paired ? p->btCount / 2 : 0;
+
+#ifdef _OPENMP
+  if (p->btNThread > 1) {
+    int c;
+#pragma omp parallel for
+    for(c=0;c<(int)nPair;c++) {
+      real *y = (real *)p->btBuf + (uint64_t)omp_get_thread_num() * 4 * n;
+      executeBatchPair(p, s, d, c*2, y, y + 2 * n);
+    }
+#pragma omp parallel for
+    for(c=nPair*2;c<(int)p->btCount;c++) executeBatchSingle(p, s, d, c);
+    return;
+  }
+#endif
+
+  for(uint32_t c=0;c<nPair;c++) {
+    real *y = (real *)p->btBuf;
+    executeBatchPair(p, s, d, c*2, y, y + 2 * n);
+  }
+  for(uint32_t c=nPair*2;c<p->btCount;c++) executeBatchSingle(p, s, d, c);
+}
+#endif // #ifdef INITBATCH
+
+#ifdef INITGRAPH
+// Execution graphs. Transforms and callbacks are added with the nodes
+// that they depend on, and are grouped into levels so that a node only
+// depends on nodes in earlier levels. The nodes in a level run
+// concurrently, and consecutive levels share one parallel region with
+// a barrier between them instead of a fork and a join per transform.
+
+EXPORT SleefDFT *INITGRAPH(uint64_t mode) {
+  SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
+  p->magic = MAGICGRAPH;
+  p->mode = mode;
+  p->baseTypeID = BASETYPEID;
+
+#ifdef _OPENMP
+  p->grNThread = (mode & SLEEF_MODE_NO_MT) != 0 ? 1 : omp_thread_count();
+#else
+  p->grNThread = 1;
+#endif
+
+  return p;
+}
+
+// Sorts the nodes by level
+static void scheduleGraph(SleefDFT *p) {
+  free(p->grLevelStart);
+  p->grLevelStart = (int32_t *)calloc(p->grNLevel + 1, sizeof(int32_t));
+  p->grOrder = (int32_t *)realloc(p->grOrder, sizeof(int32_t) * p->grCount);
+
+  for(int i=0;i<p->grCount;i++) p->grLevelStart[p->grNode[i].level + 1]++;
+  for(int l=0;l<p->grNLevel;l++) p->grLevelStart[l+1] += p->grLevelStart[l];
+
+  int32_t *pos = (int32_t *)malloc(sizeof(int32_t) * p->grNLevel);
+  memcpy(pos, p->grLevelStart, sizeof(int32_t) * p->grNLevel);
+  for(int i=0;i<p->grCount;i++) p->grOrder[pos[p->grNode[i].level]++] = i;
+  free(pos);
+}
+
+static int addNode(SleefDFT *p, SleefDFTGraphNode *node, int nDeps, const int *deps) {
+  if (p == NULL || p->magic != MAGICGRAPH || nDeps < 0 || (nDeps > 0 && deps == NULL)) return -1;
+
+  // A node can only depend on nodes added before it, so the graph has no cycle
+  int level = 0;
+  for(int i=0;i<nDeps;i++) {
+    if (deps[i] < 0 || deps[i] >= p->grCount) return -1;
+    level = MAX(level, p->grNode[deps[i]].level + 1);
+  }
+
+  if (p->grCount == p->grCapacity) {
+    p->grCapacity = MAX(16, p->grCapacity * 2);
+    p->grNode = (SleefDFTGraphNode *)realloc(p->grNode, sizeof(SleefDFTGraphNode) * p->grCapacity);
+  }
+
+  node->level = level;
+  p->grNode[p->grCount] = *node;
+  p->grNLevel = MAX(p->grNLevel, level + 1);
+
+  p->grCount++;
+  scheduleGraph(p);
+
+  return p->grCount - 1;
+}
+
+EXPORT int ADDTRANSFORM(SleefDFT *p, SleefDFT *plan, const real *in, real *out, int nDeps, const int *deps) {
+  // Only 1D plans are accepted, since they keep a scratch buffer for
+  // each thread and can be executed by several nodes at the same time
+  if (plan == NULL || plan->magic != MAGIC) return -1;
+
+  SleefDFTGraphNode node = { plan, in == NULL ? plan->in : in, out == NULL ? plan->out : out, NULL, NULL, 0 };
+  return addNode(p, &node, nDeps, deps);
+}
+
+EXPORT int ADDCALLBACK(SleefDFT *p, SleefDFT_callbackFunc func, void *arg, int nDeps, const int *deps) {
+  if (func == NULL) return -1;
+
+  SleefDFTGraphNode node = { NULL, NULL, NULL, func, arg, 0 };
+  return addNode(p, &node, nDeps, deps);
+}
+
+static void executeNode(SleefDFTGraphNode *node) {
+  if (node->plan != NULL) {
+    EXECUTE(node->plan, (const real *)node->in, (real *)node->out);
+  } else {
+    (*node->func)(node->arg);
+  }
+}
+
+#ifdef _OPENMP
+// A level with a single transform that is parallelized by itself is run
+// outside the parallel region, so that the transform can use all threads
+static int isSoloLevel(SleefDFT *p, int level) {
+  if (p->grLevelStart[level+1] - p->grLevelStart[level] != 1) return 0;
+  SleefDFT *q = p->grNode[p->grOrder[p->grLevelStart[level]]].plan;
+  return q != NULL && (q->mode2 & SLEEF_MODE2_MT1D) != 0;
+}
+#endif
+
+static void executeGraph(SleefDFT *p) {
+#ifdef _OPENMP
+  if (p->grNThread > 1) {
+    for(int l=0;l<p->grNLevel;) {
+      if (isSoloLevel(p, l)) {
+	executeNode(&p->grNode[p->grOrder[p->grLevelStart[l]]]);
+	l++;
+	continue;
+      }
+
+      int e = l;
+      while(e < p->grNLevel && !isSoloLevel(p, e)) e++;
+
+#pragma omp parallel
+      {
+	for(int k=l;k<e;k++) {
+	  int j;
+#pragma omp for schedule(dynamic)
+	  for(j=p->grLevelStart[k];j<p->grLevelStart[k+1];j++) executeNode(&p->grNode[p->grOrder[j]]);
+	}
+      }
+
+      l = e;
+    }
+    return;
+  }
+#endif
+
+  for(int j=0;j<p->grCount;j++) executeNode(&p->grNode[p->grOrder[j]]);
+}
+#endif // #ifdef INITGRAPH
+
+#ifdef INIT2DBATCH
+// Batched 2D transforms. Small images are distributed over the threads,
+// each of which transforms whole images with its own transposition
+// buffer, so that an image stays in the cache of one core. Large images
+// are transformed one by one with the 2D plan, which is parallelized
+// inside each image.
+
+#define BATCH2DCACHEBYTES (1 << 18)
+
+static void executeBatch2DAcross(SleefDFT *p, const real *s, real *d, uint32_t count) {
+  SleefDFT *q = p->inst2D;
+  const uint64_t size = 2 * (uint64_t)q->hlen * q->vlen;
+
+#ifdef _OPENMP
+  if (p->b2NThread > 1) {
+    int i;
+#pragma omp parallel for schedule(dynamic)
+    for(i=0;i<(int)count;i++) {
+      real *tBuf = (real *)p->b2Buf + (uint64_t)omp_get_thread_num() * size;
+      execute2dST(q, s + i * p->b2Stride, d + i * p->b2Stride, tBuf);
+    }
+    return;
+  }
+#endif
+
+  for(uint32_t i=0;i<count;i++) execute2dST(q, s + i * p->b2Stride, d + i * p->b2Stride, (real *)p->b2Buf);
+}
+
+static void executeBatch2DWithin(SleefDFT *p, const real *s, real *d, uint32_t count) {
+  for(uint32_t i=0;i<count;i++) EXECUTE(p->inst2D, s + i * p->b2Stride, d + i * p->b2Stride);
+}
+
+static void measureBatch2D(SleefDFT *p) {
+  SleefDFT *q = p->inst2D;
+  const uint64_t size = 2 * (uint64_t)q->hlen * q->vlen;
+
+  if (p->b2NThread <= 1) {
+    p->b2Across = 1;
+    return;
+  }
+
+  if ((p->mode & SLEEF_MODE_MEASURE) == 0 && (!planFilePathSet || (p->mode & SLEEF_MODE_MEASUREBITS) != 0)) {
+    p->b2Across = p->b2Count >= (uint32_t)p->b2NThread && size * sizeof(real) <= BATCH2DCACHEBYTES;
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Batch 2D : selected %s(estimated)\n", p->b2Across ? "across images" : "within images");
+    return;
+  }
+
+  // Enough images for all threads are transformed in each way
+
+  const uint32_t count = MIN(p->b2Count, (uint32_t)p->b2NThread * 2);
+  real *sBuf = (real *)Sleef_malloc(sizeof(real) * p->b2Stride * count);
+  real *dBuf = (real *)Sleef_malloc(sizeof(real) * p->b2Stride * count);
+
+  for(uint64_t i=0;i<p->b2Stride * count;i++) sBuf[i] = (real)(i & 7) * (real)0.125;
+
+  const int niter = 1 + 5000000 / (size * count + 1) * effortNIterX4[planEffort(p)] / 4;
+  uint64_t tm, tmAcross, tmWithin;
+
+  tm = Sleef_readCycleCounter();
+  for(int i=0;i<niter;i++) executeBatch2DAcross(p, sBuf, dBuf, count);
+  tmAcross = Sleef_readCycleCounter() - tm;
+
+  tm = Sleef_readCycleCounter();
+  for(int i=0;i<niter;i++) executeBatch2DWithin(p, sBuf, dBuf, count);
+  tmWithin = Sleef_readCycleCounter() - tm;
+
+  p->b2Across = tmAcross <= tmWithin;
+
+  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) {
+    printf("Batch 2D across(measured): %lld\n", (long long int)tmAcross);
+    printf("Batch 2D within(measured): %lld\n", (long long int)tmWithin);
+  }
+
+  Sleef_free(sBuf);
+  Sleef_free(dBuf);
+}
+
+EXPORT SleefDFT *INIT2DBATCH(uint32_t vlen, uint32_t hlen, uint32_t batch, uint64_t stride, const real *in, real *out, uint64_t mode) {
+  if (stride == 0) stride = 2 * (uint64_t)hlen * vlen;
+
+  if ((mode & (SLEEF_MODE_REAL | SLEEF_MODE_CONVBITS | SLEEF_MODE_POSTBITS)) != 0 || batch == 0 ||
+      stride < 2 * (uint64_t)hlen * vlen) return NULL;
+
+  SleefDFT *q = INIT2D(vlen, hlen, NULL, NULL, mode & ~SLEEF_MODE_ASYNC);
+  if (q == NULL) return NULL;
+
+  SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
+  p->magic = MAGIC2DBATCH;
+  p->mode = mode;
+  p->baseTypeID = BASETYPEID;
+  p->in = in;
+  p->out = out;
+  p->b2Count = batch;
+  p->b2Stride = stride;
+  p->inst2D = q;
+
+#ifdef _OPENMP
+  p->b2NThread = (mode & SLEEF_MODE_NO_MT) != 0 ? 1 : omp_thread_count();
+#else
+  p->b2NThread = 1;
+#endif
+
+  p->b2Buf = Sleef_malloc(sizeof(real) * 2 * (uint64_t)hlen * vlen * p->b2NThread);
+
+  measureBatch2D(p);
+
+  if ((mode & SLEEF_MODE_VERBOSE) != 0) {
+    printf("Batch 2D : %u images of %ux%u, %s\n", batch, vlen, hlen, p->b2Across ? "across images" : "within images");
+  }
+
+  return p;
+}
+
+static void executeBatch2D(SleefDFT *p, const real *s, real *d) {
+  if (p->b2Across) {
+    executeBatch2DAcross(p, s, d, p->b2Count);
+  } else {
+    executeBatch2DWithin(p, s, d, p->b2Count);
+  }
+}
+#endif // #ifdef INIT2DBATCH
+
+#ifdef INITOOC
+// Out-of-core transforms
+
+static uint64_t footprint1d(SleefDFT *p) {
+  return sizeof(SleefDFT) + p->tableBytes + p->scratchBytes;
+}
+
+static uint32_t ilog2u64(uint64_t q) {
+  uint32_t r = 0;
+  while((q >>= 1) != 0) r++;
+  return r;
+}
+
+EXPORT SleefDFT *INITOOC(uint64_t n, uint64_t memLimit, uint64_t mode) {
+  // The output is always in the standard order of complex transforms
+  if ((mode & (SLEEF_MODE_REAL | SLEEF_MODE_ALT | SLEEF_MODE_CONVBITS | SLEEF_MODE_POSTBITS)) != 0 || n < 16 || (n & (n-1)) != 0) return NULL;
+
+  SleefDFT *p = (SleefDFT *)calloc(1, sizeof(SleefDFT));
+  p->magic = MAGICOOC;
+  p->mode = mode;
+  p->baseTypeID = BASETYPEID;
+  p->oocLen = n;
+  p->memLimit = memLimit;
+
+  // The transform is decomposed into column transforms of length
+  // 2^log2oocRow and row transforms of length 2^log2oocCol.
+
+  p->log2oocLen = ilog2u64(n);
+  p->log2oocCol = p->log2oocLen / 2;
+  p->log2oocRow = p->log2oocLen - p->log2oocCol;
+  p->log2oocTwLo = p->log2oocLen / 2;
+
+  if (p->log2oocRow >= MAXLOG2LEN) {
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Out-of-core : transform too large\n");
+    p->magic = 0;
+    free(p);
+    return NULL;
+  }
+
+#ifdef _OPENMP
+  p->oocNThread = omp_thread_count();
+#else
+  p->oocNThread = 1;
+#endif
+
+  uint64_t mode1D = mode | SLEEF_MODE_NO_MT;
+
+  p->instOocC = p->instOocR = INIT(1U << p->log2oocRow, NULL, NULL, mode1D);
+  if (p->log2oocRow != p->log2oocCol) p->instOocR = INIT(1U << p->log2oocCol, NULL, NULL, mode1D);
+
+  if (p->instOocC == NULL || p->instOocR == NULL) {
+    if (p->instOocC != NULL) SleefDFT_dispose(p->instOocC);
+    if (p->instOocR != NULL && p->instOocR != p->instOocC) SleefDFT_dispose(p->instOocR);
+    p->magic = 0;
+    free(p);
+    return NULL;
+  }
+
+  const int sign = (mode & SLEEF_MODE_BACKWARD) != 0 ? 1 : -1;
+  const int log2twHi = p->log2oocLen - p->log2oocTwLo;
+  real *twLo = (real *)Sleef_malloc(sizeof(real) * 2 << p->log2oocTwLo);
+  real *twHi = (real *)Sleef_malloc(sizeof(real) * 2 << log2twHi);
+
+  for(uint64_t i=0;i < (UINT64_C(1) << p->log2oocTwLo);i++) {
+    Sleef_double2 sc = Sleef_sincospi_u05(sign * 2.0 * (double)i / (double)n);
+    twLo[i*2+0] = (real)sc.y; twLo[i*2+1] = (real)sc.x;
+  }
+  for(uint64_t i=0;i < (UINT64_C(1) << log2twHi);i++) {
+    Sleef_double2 sc = Sleef_sincospi_u05(sign * 2.0 * (double)(i << p->log2oocTwLo) / (double)n);
+    twHi[i*2+0] = (real)sc.y; twHi[i*2+1] = (real)sc.x;
+  }
+
+  p->oocTwLo = twLo;
+  p->oocTwHi = twHi;
+
+  // Choose the largest block that fits in memLimit together with the
+  // inner plans, twiddle tables and per-thread work areas. Four
+  // blocks are kept so that reading, computing and writing overlap.
+
+  uint64_t fixed = footprint1d(p->instOocC) + (p->instOocC != p->instOocR ? footprint1d(p->instOocR) : 0);
+  fixed += sizeof(real) * 2 * ((UINT64_C(1) << p->log2oocTwLo) + (UINT64_C(1) << log2twHi));
+  fixed += p->oocNThread * sizeof(real) * (UINT64_C(4) << p->log2oocRow);
+
+  int log2block = -1;
+  for(int lb = p->log2oocRow;lb <= p->log2oocLen;lb++) {
+    if (fixed + sizeof(real) * (UINT64_C(8) << lb) > memLimit) break;
+    log2block = lb;
+  }
+
+  if (log2block == -1) {
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Out-of-core : memLimit too small, at least %lld bytes required\n",
+						    (long long int)(fixed + sizeof(real) * (UINT64_C(8) << p->log2oocRow)));
+    SleefDFT_dispose(p);
+    return NULL;
+  }
+
+  p->log2oocBlock1 = log2block - p->log2oocRow;
+  p->log2oocBlock2 = log2block - p->log2oocCol;
+
+  if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Out-of-core : %d x %d, block %lld bytes\n", 1 << p->log2oocRow, 1 << p->log2oocCol,
+						  (long long int)(sizeof(real) * (UINT64_C(2) << log2block)));
+
+  return p;
+}
+
+// Pass 0 : column transforms. Reads 2^log2oocRow chunks of W elements
+// with stride 2^log2oocCol from the input, multiplies the twiddle
+// factors and writes W transformed columns contiguously to the output.
+//
+// Pass 1 : row transforms. Reads and writes 2^log2oocCol chunks of H
+// elements with stride 2^log2oocRow in the output, in place.
+
+static int oocRead(SleefDFT *p, int pass, uint64_t b, real *buf, SleefDFT_readFunc readFunc, void *ctx) {
+  const uint64_t R = UINT64_C(1) << p->log2oocRow, C = UINT64_C(1) << p->log2oocCol;
+  const uint64_t E = sizeof(real) * 2;
+
+  if (pass == 0) {
+    const uint64_t W = UINT64_C(1) << p->log2oocBlock1;
+    for(uint64_t j2=0;j2<R;j2++) {
+      if ((*readFunc)(ctx, SLEEF_OOC_INPUT, (j2 * C + b * W) * E, &buf[j2 * W * 2], W * E) != 0) return -1;
+    }
+  } else {
+    const uint64_t H = UINT64_C(1) << p->log2oocBlock2;
+    for(uint64_t j1=0;j1<C;j1++) {
+      if ((*readFunc)(ctx, SLEEF_OOC_OUTPUT, (j1 * R + b * H) * E, &buf[j1 * H * 2], H * E) != 0) return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int oocWrite(SleefDFT *p, int pass, uint64_t b, const real *buf, SleefDFT_writeFunc writeFunc, void *ctx) {
+  const uint64_t R = UINT64_C(1) << p->log2oocRow, C = UINT64_C(1) << p->log2oocCol;
+  const uint64_t E = sizeof(real) * 2;
+
+  if (pass == 0) {
+    const uint64_t W = UINT64_C(1) << p->log2oocBlock1;
+    if ((*writeFunc)(ctx, b * W * R * E, buf, W * R * E) != 0) return -1;
+  } else {
+    const uint64_t H = UINT64_C(1) << p->log2oocBlock2;
+    for(uint64_t k1=0;k1<C;k1++) {
+      if ((*writeFunc)(ctx, (k1 * R + b * H) * E, &buf[k1 * H * 2], H * E) != 0) return -1;
+    }
+  }
+
+  return 0;
+}
+
+static void oocCompute(SleefDFT *p, int pass, uint64_t b, uint64_t i, const real *in, real *out, real *t0, real *t1) {
+  if (pass == 0) {
+    const uint64_t R = UINT64_C(1) << p->log2oocRow, W = UINT64_C(1) << p->log2oocBlock1;
+    const uint64_t mask = p->oocLen - 1, loMask = (UINT64_C(1) << p->log2oocTwLo) - 1;
+    const uint64_t j1 = b * W + i;
+    const real *twLo = (const real *)p->oocTwLo, *twHi = (const real *)p->oocTwHi;
+
+    for(uint64_t j2=0;j2<R;j2++) {
+      t0[j2*2+0] = in[(j2 * W + i)*2+0];
+      t0[j2*2+1] = in[(j2 * W + i)*2+1];
+    }
+
+    EXECUTE(p->instOocC, t0, t1);
+
+    for(uint64_t k2=0;k2<R;k2++) {
+      const uint64_t m = (j1 * k2) & mask, lo = m & loMask, hi = m >> p->log2oocTwLo;
+      real wr = twHi[hi*2+0] * twLo[lo*2+0] - twHi[hi*2+1] * twLo[lo*2+1];
+      real wi = twHi[hi*2+0] * twLo[lo*2+1] + twHi[hi*2+1] * twLo[lo*2+0];
+      out[(i * R + k2)*2+0] = t1[k2*2+0] * wr - t1[k2*2+1] * wi;
+      out[(i * R + k2)*2+1] = t1[k2*2+0] * wi + t1[k2*2+1] * wr;
+    }
+  } else {
+    const uint64_t C = UINT64_C(1) << p->log2oocCol, H = UINT64_C(1) << p->log2oocBlock2;
+
+    for(uint64_t j1=0;j1<C;j1++) {
+      t0[j1*2+0] = in[(j1 * H + i)*2+0];
+      t0[j1*2+1] = in[(j1 * H + i)*2+1];
+    }
+
+    EXECUTE(p->instOocR, t0, t1);
+
+    for(uint64_t k1=0;k1<C;k1++) {
+      out[(k1 * H + i)*2+0] = t1[k1*2+0];
+      out[(k1 * H + i)*2+1] = t1[k1*2+1];
+    }
+  }
+}
+
+EXPORT int EXECUTEOOC(SleefDFT *p, SleefDFT_readFunc readFunc, SleefDFT_writeFunc writeFunc, void *ctx) {
+  assert(p != NULL && p->magic == MAGICOOC);
+
+  const uint64_t blockLen = UINT64_C(1) << (p->log2oocBlock1 + p->log2oocRow);
+  const uint64_t R = UINT64_C(1) << p->log2oocRow;
+
+  real *inBuf[2], *outBuf[2];
+  for(int i=0;i<2;i++) {
+    inBuf[i]  = (real *)Sleef_malloc(sizeof(real) * 2 * blockLen);
+    outBuf[i] = (real *)Sleef_malloc(sizeof(real) * 2 * blockLen);
+  }
+  real *tmp = (real *)Sleef_malloc(sizeof(real) * p->oocNThread * 4 * R);
+
+  int err = 0;
+
+  for(int pass=0;pass<2 && err == 0;pass++) {
+    const uint64_t nb = UINT64_C(1) << (pass == 0 ? p->log2oocCol - p->log2oocBlock1 : p->log2oocRow - p->log2oocBlock2);
+    const uint64_t cnt = UINT64_C(1) << (pass == 0 ? p->log2oocBlock1 : p->log2oocBlock2);
+
+    err = oocRead(p, pass, 0, inBuf[0], readFunc, ctx);
+
+    // While block b is transformed, thread 0 writes back block b-1
+    // and reads block b+1, then joins the computation.
+
+    for(uint64_t b=0;b<nb && err == 0;b++) {
+      const real *in = inBuf[b & 1];
+      real *out = outBuf[b & 1];
+      int ioErr = 0;
+#ifdef _OPENMP
+      int64_t next = 0;
+#pragma omp parallel
+      {
+	const int tn = omp_get_thread_num();
+	if (tn == 0) {
+	  if (b > 0) ioErr |= oocWrite(p, pass, b-1, outBuf[(b-1) & 1], writeFunc, ctx);
+	  if (b+1 < nb) ioErr |= oocRead(p, pass, b+1, inBuf[(b+1) & 1], readFunc, ctx);
+	}
+	for(;;) {
+	  int64_t i;
+#pragma omp atomic capture
+	  i = next++;
+	  if (i >= (int64_t)cnt) break;
+	  oocCompute(p, pass, b, i, in, out, &tmp[tn * 4 * R], &tmp[(tn * 4 + 2) * R]);
+	}
+      }
+#else
+      if (b > 0) ioErr |= oocWrite(p, pass, b-1, outBuf[(b-1) & 1], writeFunc, ctx);
+      if (b+1 < nb) ioErr |= oocRead(p, pass, b+1, inBuf[(b+1) & 1], readFunc, ctx);
+      for(uint64_t i=0;i<cnt;i++) oocCompute(p, pass, b, i, in, out, &tmp[0], &tmp[2 * R]);
+#endif
+      err |= ioErr;
+    }
+
+    if (err == 0) err = oocWrite(p, pass, nb-1, outBuf[(nb-1) & 1], writeFunc, ctx);
+  }
+
+  Sleef_free(tmp);
+  for(int i=0;i<2;i++) {
+    Sleef_free(outBuf[i]);
+    Sleef_free(inBuf[i]);
+  }
+
+  return err;
+}
+
+EXPORT int EXECUTEFILE(SleefDFT *p, const char *inPath, const char *outPath) {
+  assert(p != NULL && p->magic == MAGICOOC);
+
+  OutOfCoreFile *f = OutOfCoreFile_open(inPath, outPath, p->oocLen * 2 * sizeof(real));
+  if (f == NULL) return -1;
+
+  int ret = EXECUTEOOC(p, OutOfCoreFile_read, OutOfCoreFile_write, f);
+
+  OutOfCoreFile_close(f);
+  return ret;
+}
+#endif // #ifdef INITOOC
@@ -3,6 +3,10 @@
 //    (See accompanying file LICENSE.txt or copy at
 //          http://www.boost.org/LICENSE_1_0.txt)
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // for sched_setaffinity
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -17,6 +21,10 @@
 #include <omp.h>
 #endif
 
+#if defined(__linux__) && defined(_OPENMP)
+#include <sched.h>
+#endif
+
 #include "misc.h"
 #include "sleef.h"
 
@@ -26,12 +34,37 @@
 #include "dftcommon.h"
 #include "common.h"
 #include "arraymap.h"
+#include "planstore.h"
 
 #define MAGIC_FLOAT 0x31415926
 #define MAGIC_DOUBLE 0x27182818
+#define MAGIC_LONGDOUBLE 0x69314718
+#define MAGIC_QUAD 0x57721566
 
 #define MAGIC2D_FLOAT 0x22360679
 #define MAGIC2D_DOUBLE 0x17320508
+#define MAGIC2D_LONGDOUBLE 0x26457513
+#define MAGIC2D_QUAD 0x24494897
+
+#define MAGICOOC_FLOAT 0x16180339
+#define MAGICOOC_DOUBLE 0x14142135
+
+#define MAGICPRUNED_FLOAT 0x30102999
+#define MAGICPRUNED_DOUBLE 0x47712125
+#define MAGICBATCH_FLOAT 0x44721359
+#define MAGICBATCH_DOUBLE 0x16487212
+#define MAGIC2DBATCH_FLOAT 0x17724538
+#define MAGIC2DBATCH_DOUBLE 0x26180339
+#define MAGICGRAPH_FLOAT 0x84509804
+#define MAGICGRAPH_DOUBLE 0x69897000
+
+static int is1DPlan(SleefDFT *p) {
+  return p->magic == MAGIC_FLOAT || p->magic == MAGIC_DOUBLE || p->magic == MAGIC_LONGDOUBLE || p->magic == MAGIC_QUAD;
+}
+
+static int is2DPlan(SleefDFT *p) {
+  return p->magic == MAGIC2D_FLOAT || p->magic == MAGIC2D_DOUBLE || p->magic == MAGIC2D_LONGDOUBLE || p->magic == MAGIC2D_QUAD;
+}
 
 const char *configStr[] = { "ST", "ST stream", "MT", "MT stream" };
 
@@ -72,7 +105,7 @@ static int parsePathStr(char *p, int *path, int *config, int pathLenMax, int log
 }
 
 EXPORT void SleefDFT_setPath(SleefDFT *p, char *pathStr) {
-  assert(p != NULL && (p->magic == MAGIC_FLOAT || p->magic == MAGIC_DOUBLE));
+  assert(p != NULL && is1DPlan(p));
 
   int path[32], config[32];
   int pathLen = parsePathStr(pathStr, path, config, 31, p->log2len);
@@ -101,6 +134,126 @@ EXPORT void SleefDFT_setPath(SleefDFT *p, char *pathStr) {
   }
 }
 
+// The plan measured in the background replaces the initial plan once it is published
+static SleefDFT *currentPlan(SleefDFT *p) {
+  if (p->asyncThread != NULL) {
+    SleefDFT *q = (SleefDFT *)atomicLoadPtr((void **)&p->asyncPlan);
+    if (q != NULL) return q;
+  }
+  return p;
+}
+
+static int samePath(SleefDFT *p, SleefDFT *q) {
+  if (p->log2len != q->log2len || p->pathLen != q->pathLen) return 0;
+  for(int level = p->log2len;level >= 0;level--) {
+    if (p->bestPath[level] != q->bestPath[level]) return 0;
+    if (p->bestPath[level] != 0 && p->bestPathConfig[level] != q->bestPathConfig[level]) return 0;
+  }
+  return 1;
+}
+
+// A 2D plan is described by its row and column plans. The row
+// transform is executed once per row, and the column transform once
+// per column.
+static int getInfo2D(SleefDFT *p, SleefDFT_info *info) {
+  SleefDFT_info h, v;
+  if (SleefDFT_getInfo(p->instH, &h) != 0 || SleefDFT_getInfo(p->instV, &v) != 0) return -1;
+
+  memset(info, 0, sizeof(SleefDFT_info));
+  info->isaName = h.isaName;
+  info->vectorBits = h.vectorBits;
+  info->log2len = p->log2hlen + p->log2vlen;
+  info->estimatedTime = h.estimatedTime * p->vlen + v.estimatedTime * p->hlen;
+  info->measuredTime = h.measuredTime * p->vlen + v.measuredTime * p->hlen;
+  info->tableBytes = h.tableBytes + (p->instV != p->instH ? v.tableBytes : 0);
+  info->scratchBytes = h.scratchBytes + (p->instV != p->instH ? v.scratchBytes : 0) + p->tBufBytes * (1 + p->nHBuf);
+  info->transposeMT = (p->mode3 & SLEEF_MODE3_MT2D) != 0 && p->tmMT < p->tmNoMT;
+  info->rowPlan = p->instH;
+  info->columnPlan = p->instV;
+
+  return 0;
+}
+
+EXPORT int SleefDFT_getInfo(SleefDFT *p, SleefDFT_info *info) {
+  assert(p != NULL);
+  if (is2DPlan(p)) return getInfo2D(p, info);
+  if (!is1DPlan(p)) return -1;
+  p = currentPlan(p);
+
+  memset(info, 0, sizeof(SleefDFT_info));
+  info->isaName = p->isaName;
+  info->vectorBits = p->vectorBits;
+  info->log2len = p->log2len;
+  info->estimatedTime = p->estimatedTime;
+  info->measuredTime = p->measuredTime;
+  info->tableBytes = p->tableBytes;
+  info->scratchBytes = p->scratchBytes;
+
+  for(int level = p->log2len;level >= 1 && p->bestPath[level] != 0;) {
+    info->path[info->pathLen] = ABS(p->bestPath[level]);
+    info->config[info->pathLen] = p->bestPathConfig[level];
+    info->pathLen++;
+    level -= ABS(p->bestPath[level]);
+  }
+
+  return 0;
+}
+
+// The returned string can be given to SleefDFT_setPath
+EXPORT int SleefDFT_getPath(SleefDFT *p, char *pathStr, int size) {
+  SleefDFT_info info;
+  if (SleefDFT_getInfo(p, &info) != 0) return -1;
+
+  int len = 0;
+  for(int j=0;j<info.pathLen;j++) {
+    int z = snprintf(pathStr == NULL ? NULL : pathStr + MIN(len, size), pathStr == NULL ? 0 : size - MIN(len, size),
+		     "%s%d(%s)", j == 0 ? "" : " ", info.path[j], configStr[info.config[j]]);
+    len += z;
+  }
+  if (pathStr != NULL && size > 0 && info.pathLen == 0) pathStr[0] = '\0';
+
+  return len;
+}
+
+// Entry j of the counters corresponds to the j-th stage of the path,
+// and the entry following the last stage to the pre- and
+// post-processing of real transforms.
+EXPORT int SleefDFT_getCounters(SleefDFT *p, uint64_t *ticks, uint64_t *calls, int n) {
+  assert(p != NULL);
+  if (!is1DPlan(p) || (p->mode & SLEEF_MODE_COUNTERS) == 0) return -1;
+  SleefDFT *q = currentPlan(p);
+
+  // The counts of the initial plan are carried over to the plan
+  // measured in the background if both plans take the same path
+  int carry = q != p && samePath(p, q);
+
+  int nStage = q->pathLen + ((q->mode & SLEEF_MODE_REAL) != 0 ? 1 : 0);
+  for(int j=0;j<n && j<nStage;j++) {
+    if (ticks != NULL) ticks[j] = q->stageTicks[j] + (carry ? p->stageTicks[j] : 0);
+    if (calls != NULL) calls[j] = q->stageCalls[j] + (carry ? p->stageCalls[j] : 0);
+  }
+
+  return nStage;
+}
+
+EXPORT void SleefDFT_resetCounters(SleefDFT *p) {
+  assert(p != NULL);
+  if (is2DPlan(p)) {
+    SleefDFT_resetCounters(p->instH);
+    if (p->instV != p->instH) SleefDFT_resetCounters(p->instV);
+    return;
+  }
+  if (!is1DPlan(p)) return;
+  SleefDFT *q = currentPlan(p);
+
+  memset(p->stageTicks, 0, sizeof(p->stageTicks));
+  memset(p->stageCalls, 0, sizeof(p->stageCalls));
+  if (q != p) {
+    memset(q->stageTicks, 0, sizeof(q->stageTicks));
+    memset(q->stageCalls, 0, sizeof(q->stageCalls));
+  }
+}
+
 void freeTables(SleefDFT *p) {
   for(int N=1;N<=MAXBUTWIDTH;N++) {
     for(uint32_t level=N;level<=p->log2len;level++) {
@@ -111,8 +264,22 @@ void freeTables(SleefDFT *p) {
   }
 }
 
+// Staging buffers for transforms with 16-bit input and output
+static void freeHBuf(SleefDFT *p) {
+  for(int i=0;i<p->nHBuf;i++) Sleef_free(p->hBuf[i]);
+  free(p->hBuf);
+  p->hBuf = NULL;
+  p->nHBuf = 0;
+}
+
 EXPORT void SleefDFT_dispose(SleefDFT *p) {
-  if (p != NULL && (p->magic == MAGIC2D_FLOAT || p->magic == MAGIC2D_DOUBLE)) {
+  if (p != NULL) {
+    RealtimeMemory_unlockAll(p);
+    RealtimeThreads_unpin(p);
+  }
+
+  if (p != NULL && is2DPlan(p)) {
+    freeHBuf(p);
     Sleef_free(p->tBuf);
     SleefDFT_dispose(p->instH);
     if (p->hlen != p->vlen) SleefDFT_dispose(p->instV);
@@ -122,7 +289,64 @@ EXPORT void SleefDFT_dispose(SleefDFT *p) {
     return;
   }
 
-  assert(p != NULL && (p->magic == MAGIC_FLOAT || p->magic == MAGIC_DOUBLE));
+  if (p != NULL && (p->magic == MAGICOOC_FLOAT || p->magic == MAGICOOC_DOUBLE)) {
+    Sleef_free(p->oocTwLo);
+    Sleef_free(p->oocTwHi);
+    SleefDFT_dispose(p->instOocC);
+    if (p->log2oocRow != p->log2oocCol) SleefDFT_dispose(p->instOocR);
+
+    p->magic = 0;
+    free(p);
+    return;
+  }
+
+  if (p != NULL && (p->magic == MAGICPRUNED_FLOAT || p->magic == MAGICPRUNED_DOUBLE)) {
+    Sleef_free(p->prTw);
+    Sleef_free(p->prBuf);
+    SleefDFT_dispose(p->instPr);
+
+    p->magic = 0;
+    free(p);
+    return;
+  }
+
+  if (p != NULL && (p->magic == MAGICBATCH_FLOAT || p->magic == MAGICBATCH_DOUBLE)) {
+    if (p->btBuf != NULL) Sleef_free(p->btBuf);
+    if (p->instBtC != NULL) SleefDFT_dispose(p->instBtC);
+    SleefDFT_dispose(p->instBtR);
+
+    p->magic = 0;
+    free(p);
+    return;
+  }
+
+  if (p != NULL && (p->magic == MAGIC2DBATCH_FLOAT || p->magic == MAGIC2DBATCH_DOUBLE)) {
+    Sleef_free(p->b2Buf);
+    SleefDFT_dispose(p->inst2D);
+
+    p->magic = 0;
+    free(p);
+    return;
+  }
+
+  // The plans in a graph are owned by the caller
+  if (p != NULL && (p->magic == MAGICGRAPH_FLOAT || p->magic == MAGICGRAPH_DOUBLE)) {
+    free(p->grNode);
+    free(p->grOrder);
+    free(p->grLevelStart);
+
+    p->magic = 0;
+    free(p);
+    return;
+  }
+
+  assert(p != NULL && is1DPlan(p));
+
+  if (p->asyncThread != NULL) {
+    BackgroundThread_join(p->asyncThread);
+    if (p->asyncPlan != NULL) SleefDFT_dispose(p->asyncPlan);
+    p->asyncThread = NULL;
+  }
 
   if (p->log2len <= 1) {
     p->magic = 0;
@@ -130,6 +354,8 @@ EXPORT void SleefDFT_dispose(SleefDFT *p) {
     return;
   }
   
+  freeHBuf(p);
+
   if ((p->mode & SLEEF_MODE_REAL) != 0) {
     Sleef_free(p->rtCoef1);
     Sleef_free(p->rtCoef0);
@@ -148,6 +374,417 @@ EXPORT void SleefDFT_dispose(SleefDFT *p) {
   free(p);
 }
 
+// File access for out-of-core transforms
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+struct OutOfCoreFile {
+  int inFd, outFd;
+  uint64_t size;
+  const char *inMap;
+  char *outMap;
+};
+
+OutOfCoreFile *OutOfCoreFile_open(const char *inPath, const char *outPath, uint64_t size) {
+  struct stat st;
+  OutOfCoreFile *f = (OutOfCoreFile *)calloc(1, sizeof(OutOfCoreFile));
+  f->size = size;
+  f->inFd = f->outFd = -1;
+
+  f->inFd = open(inPath, O_RDONLY);
+  if (f->inFd == -1 || fstat(f->inFd, &st) != 0 || (uint64_t)st.st_size < size) goto error;
+
+  f->outFd = open(outPath, O_RDWR | O_CREAT, 0644);
+  if (f->outFd == -1 || ftruncate(f->outFd, (off_t)size) != 0) goto error;
+
+  f->inMap = mmap(NULL, size, PROT_READ, MAP_SHARED, f->inFd, 0);
+  if (f->inMap == MAP_FAILED) { f->inMap = NULL; goto error; }
+
+  f->outMap = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, f->outFd, 0);
+  if (f->outMap == MAP_FAILED) { f->outMap = NULL; goto error; }
+
+  return f;
+
+ error:
+  OutOfCoreFile_close(f);
+  return NULL;
+}
+
+void OutOfCoreFile_close(OutOfCoreFile *f) {
+  if (f->outMap != NULL) munmap(f->outMap, f->size);
+  if (f->inMap != NULL) munmap((void *)f->inMap, f->size);
+  if (f->outFd != -1) close(f->outFd);
+  if (f->inFd != -1) close(f->inFd);
+  free(f);
+}
+
+int OutOfCoreFile_read(void *ctx, int target, uint64_t offset, void *buf, uint64_t size) {
+  OutOfCoreFile *f = (OutOfCoreFile *)ctx;
+  if (offset + size > f->size) return -1;
+  memcpy(buf, (target == SLEEF_OOC_INPUT ? f->inMap : f->outMap) + offset, size);
+  return 0;
+}
+
+int OutOfCoreFile_write(void *ctx, uint64_t offset, const void *buf, uint64_t size) {
+  OutOfCoreFile *f = (OutOfCoreFile *)ctx;
+  if (offset + size > f->size) return -1;
+  memcpy(f->outMap + offset, buf, size);
+  return 0;
+}
+#else // #if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+struct OutOfCoreFile {
+  FILE *inFp, *outFp;
+  uint64_t size;
+};
+
+OutOfCoreFile *OutOfCoreFile_open(const char *inPath, const char *outPath, uint64_t size) {
+  OutOfCoreFile *f = (OutOfCoreFile *)calloc(1, sizeof(OutOfCoreFile));
+  f->size = size;
+  f->inFp = fopen(inPath, "rb");
+  f->outFp = fopen(outPath, "w+b");
+  if (f->inFp == NULL || f->outFp == NULL) {
+    OutOfCoreFile_close(f);
+    return NULL;
+  }
+  return f;
+}
+
+void OutOfCoreFile_close(OutOfCoreFile *f) {
+  if (f->outFp != NULL) fclose(f->outFp);
+  if (f->inFp != NULL) fclose(f->inFp);
+  free(f);
+}
+
+int OutOfCoreFile_read(void *ctx, int target, uint64_t offset, void *buf, uint64_t size) {
+  OutOfCoreFile *f = (OutOfCoreFile *)ctx;
+  FILE *fp = target == SLEEF_OOC_INPUT ? f->inFp : f->outFp;
+  if (offset + size > f->size || _fseeki64(fp, offset, SEEK_SET) != 0) return -1;
+  return fread(buf, 1, size, fp) == size ? 0 : -1;
+}
+
+int OutOfCoreFile_write(void *ctx, uint64_t offset, const void *buf, uint64_t size) {
+  OutOfCoreFile *f = (OutOfCoreFile *)ctx;
+  if (offset + size > f->size || _fseeki64(f->outFp, offset, SEEK_SET) != 0) return -1;
+  return fwrite(buf, 1, size, f->outFp) == size ? 0 : -1;
+}
+#endif // #if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+
+// Background threads for asynchronous planning
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+#include <pthread.h>
+
+void *BackgroundThread_start(void *(*func)(void *), void *arg) {
+  pthread_t *th = (pthread_t *)malloc(sizeof(pthread_t));
+  if (pthread_create(th, NULL, func, arg) != 0) {
+    free(th);
+    return NULL;
+  }
+  return th;
+}
+
+void BackgroundThread_join(void *thread) {
+  pthread_join(*(pthread_t *)thread, NULL);
+  free(thread);
+}
+
+void *atomicLoadPtr(void **ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+void atomicStorePtr(void **ptr, void *value) { __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+void atomicAddU64(uint64_t *ptr, uint64_t value) { __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED); }
+#else // #if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+#include <windows.h>
+
+typedef struct {
+  void *(*func)(void *);
+  void *arg;
+} threadArg_t;
+
+static DWORD WINAPI threadEntry(LPVOID p) {
+  threadArg_t a = *(threadArg_t *)p;
+  free(p);
+  (*a.func)(a.arg);
+  return 0;
+}
+
+void *BackgroundThread_start(void *(*func)(void *), void *arg) {
+  threadArg_t *a = (threadArg_t *)malloc(sizeof(threadArg_t));
+  a->func = func;
+  a->arg = arg;
+  HANDLE h = CreateThread(NULL, 0, threadEntry, a, 0, NULL);
+  if (h == NULL) {
+    free(a);
+    return NULL;
+  }
+  return (void *)h;
+}
+
+void BackgroundThread_join(void *thread) {
+  WaitForSingleObject((HANDLE)thread, INFINITE);
+  CloseHandle((HANDLE)thread);
+}
+
+void *atomicLoadPtr(void **ptr) { return InterlockedCompareExchangePointer(ptr, NULL, NULL); }
+void atomicStorePtr(void **ptr, void *value) { InterlockedExchangePointer(ptr, value); }
+void atomicAddU64(uint64_t *ptr, uint64_t value) { InterlockedExchangeAdd64((LONG64 volatile *)ptr, (LONG64)value); }
+#endif // #if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+
+// Memory and threads of plans in SLEEF_MODE_REALTIME
+
+#if !(defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER))
+static int lockPages(void *ptr, uint64_t size) { return mlock(ptr, size) == 0; }
+static void unlockPages(void *ptr, uint64_t size) { munlock(ptr, size); }
+#else
+static int lockPages(void *ptr, uint64_t size) { return VirtualLock(ptr, size) != 0; }
+static void unlockPages(void *ptr, uint64_t size) { VirtualUnlock(ptr, size); }
+#endif
+
+// Each page of the region is written once so that it is mapped even
+// if locking fails, e.g. because of RLIMIT_MEMLOCK
+void RealtimeMemory_lock(SleefDFT *p, void *ptr, uint64_t size) {
+  if (ptr == NULL || size == 0) return;
+
+  volatile char *c = (volatile char *)ptr;
+  for(uint64_t i=0;i<size;i+=1024) c[i] = c[i];
+  c[size-1] = c[size-1];
+
+  if (!lockPages(ptr, size)) {
+    if ((p->mode & SLEEF_MODE_VERBOSE) != 0) printf("Locking %llu bytes failed\n", (unsigned long long)size);
+    return;
+  }
+
+  p->rtPtr = (void **)realloc(p->rtPtr, sizeof(void *) * (p->nRt + 1));
+  p->rtSize = (uint64_t *)realloc(p->rtSize, sizeof(uint64_t) * (p->nRt + 1));
+  p->rtPtr[p->nRt] = ptr;
+  p->rtSize[p->nRt] = size;
+  p->nRt++;
+}
+
+void RealtimeMemory_unlockAll(SleefDFT *p) {
+  for(int i=0;i<p->nRt;i++) unlockPages(p->rtPtr[i], p->rtSize[i]);
+  free(p->rtPtr);
+  free(p->rtSize);
+  p->rtPtr = NULL;
+  p->rtSize = NULL;
+  p->nRt = 0;
+}
+
+// Binds the i-th OpenMP thread to the i-th CPU that the process may
+// run on, unless the binding is already specified with OMP_PROC_BIND.
+// The affinity of each worker thread is saved when the first plan
+// pins them, and is restored when the last such plan is disposed.
+
+#if defined(__linux__) && defined(_OPENMP)
+static int rtPinCount = 0, rtNSaved = 0;
+static cpu_set_t *rtSaved = NULL;
+#endif
+
+void RealtimeThreads_pin(SleefDFT *p) {
+#if defined(__linux__) && defined(_OPENMP)
+  if (p->rtPinned) return;
+  p->rtPinned = 1;
+
+#pragma omp critical (RealtimeThreads)
+  if (rtPinCount++ == 0 && omp_get_proc_bind() == omp_proc_bind_false) {
+    cpu_set_t avail;
+    const int nSaved = omp_get_max_threads();
+    rtSaved = (cpu_set_t *)calloc(nSaved, sizeof(cpu_set_t));
+
+    if (rtSaved != NULL && sched_getaffinity(0, sizeof(avail), &avail) == 0 && CPU_COUNT(&avail) != 0) {
+      const int nCPU = CPU_COUNT(&avail);
+      rtNSaved = nSaved;
+
+      // Thread 0 is the thread of the application that called the
+      // library, and its affinity is left as it is
+
+#pragma omp parallel num_threads(nSaved)
+      if (omp_get_thread_num() != 0) {
+	int k = omp_get_thread_num() % nCPU, cpu;
+	for(cpu=0;cpu<CPU_SETSIZE;cpu++) if (CPU_ISSET(cpu, &avail) && k-- == 0) break;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (sched_getaffinity(0, sizeof(rtSaved[0]), &rtSaved[omp_get_thread_num()]) == 0)
+	  sched_setaffinity(0, sizeof(set), &set);
+      }
+    }
+  }
+#endif
+}
+
+// The worker threads are the same as when they were pinned, as long
+// as the application keeps the size of the OpenMP thread pool
+void RealtimeThreads_unpin(SleefDFT *p) {
+#if defined(__linux__) && defined(_OPENMP)
+  if (!p->rtPinned) return;
+  p->rtPinned = 0;
+
+#pragma omp critical (RealtimeThreads)
+  if (--rtPinCount == 0) {
+    if (rtNSaved != 0) {
+#pragma omp parallel num_threads(rtNSaved)
+      {
+	const int i = omp_get_thread_num();
+	if (i != 0 && CPU_COUNT(&rtSaved[i]) != 0) sched_setaffinity(0, sizeof(rtSaved[i]), &rtSaved[i]);
+      }
+    }
+    free(rtSaved);
+    rtSaved = NULL;
+    rtNSaved = 0;
+  }
+#endif
+}
+
+// Brings the tables of a plan into cache and wakes up the worker
+// threads, so that the next execution does not pay for them
+EXPORT void SleefDFT_prefetch(SleefDFT *p) {
+  assert(p != NULL);
+
+  if (is2DPlan(p)) {
+    SleefDFT_prefetch(p->instH);
+    if (p->hlen != p->vlen) SleefDFT_prefetch(p->instV);
+  } else if (p->magic == MAGICPRUNED_FLOAT || p->magic == MAGICPRUNED_DOUBLE) {
+    SleefDFT_prefetch(p->instPr);
+  } else if (p->magic == MAGICBATCH_FLOAT || p->magic == MAGICBATCH_DOUBLE) {
+    if (p->instBtC != NULL) SleefDFT_prefetch(p->instBtC);
+    SleefDFT_prefetch(p->instBtR);
+  } else if (p->magic == MAGIC2DBATCH_FLOAT || p->magic == MAGIC2DBATCH_DOUBLE) {
+    SleefDFT_prefetch(p->inst2D);
+  } else if (p->magic == MAGICGRAPH_FLOAT || p->magic == MAGICGRAPH_DOUBLE) {
+    for(int i=0;i<p->grCount;i++) {
+      SleefDFT *q = p->grNode[i].plan;
+      if (q != NULL && (i == 0 || q != p->grNode[i-1].plan)) SleefDFT_prefetch(q);
+    }
+  }
+
+  for(int i=0;i<p->nRt;i++) {
+    volatile const char *c = (volatile const char *)p->rtPtr[i];
+    for(uint64_t j=0;j<p->rtSize[i];j+=64) (void)c[j];
+  }
+
+#ifdef _OPENMP
+  if ((p->mode & SLEEF_MODE_NO_MT) == 0) {
+#pragma omp parallel
+    {
+    }
+  }
+#endif
+}
+
+// Path search
+
+// A transform of 2^nLevel points is a sequence of stages, where a
+// stage at level L with width N leaves level L-N. Given the cost of
+// each stage, the k cheapest sequences from nLevel down to 0 are found
+// by a dynamic program over levels. For each level, the k cheapest
+// completions are kept in ascending order of cost, and those of a
+// level are obtained by merging the lists of the levels it can reach
+// with a priority queue. Stage costs of 1ULL << 60 or more mean that
+// the stage cannot be used.
+
+typedef struct {
+  uint64_t cost;
+  int32_t N, rank;
+} PathSearchEntry;
+
+static int pathSearchLess(const PathSearchEntry *a, const PathSearchEntry *b) {
+  if (a->cost != b->cost) return a->cost < b->cost;
+  if (a->N != b->N) return a->N < b->N;
+  return a->rank < b->rank;
+}
+
+static void pathSearchPush(PathSearchEntry *heap, int *n, PathSearchEntry e) {
+  int i = (*n)++;
+  while(i > 0 && pathSearchLess(&e, &heap[(i-1)/2])) {
+    heap[i] = heap[(i-1)/2];
+    i = (i-1)/2;
+  }
+  heap[i] = e;
+}
+
+static PathSearchEntry pathSearchPop(PathSearchEntry *heap, int *n) {
+  PathSearchEntry top = heap[0], e = heap[--(*n)];
+  int i = 0;
+  for(;;) {
+    int c = i*2+1;
+    if (c >= *n) break;
+    if (c+1 < *n && pathSearchLess(&heap[c+1], &heap[c])) c++;
+    if (!pathSearchLess(&heap[c], &e)) break;
+    heap[i] = heap[c];
+    i = c;
+  }
+  heap[i] = e;
+  return top;
+}
+
+// Finds at most k paths from nLevel to 0 whose stages are at most
+// maxN wide. The width of the stage starting at level L of the i-th
+// path is stored to path[i*(nLevel+1)+L], and 0 is stored for the
+// levels where no stage starts. Returns the number of paths found.
+
+int PathSearch_kShortest(int nLevel, int maxN, uint64_t (*stageCost)(void *ctx, int level, int N), void *ctx,
+			 int k, int32_t *path, uint64_t *pathCost) {
+  if (nLevel < 1 || maxN < 1 || k < 1) return 0;
+  if (maxN > nLevel) maxN = nLevel;
+
+  PathSearchEntry *best = malloc(sizeof(PathSearchEntry) * k * (nLevel+1));
+  int *nBest = calloc(nLevel+1, sizeof(int));
+  uint64_t *cost = malloc(sizeof(uint64_t) * (maxN+1));
+  PathSearchEntry *heap = malloc(sizeof(PathSearchEntry) * maxN);
+
+  best[0] = (PathSearchEntry) { 0, 0, 0 };
+  nBest[0] = 1;
+
+  for(int level=1;level<=nLevel;level++) {
+    int nHeap = 0;
+    for(int N=1;N<=maxN && N<=level;N++) {
+      cost[N] = stageCost(ctx, level, N);
+      if (cost[N] >= 1ULL << 60 || nBest[level-N] == 0) continue;
+      const PathSearchEntry *b = &best[(level-N)*k];
+      if (b[0].cost >= (1ULL << 60) - cost[N]) continue;
+      pathSearchPush(heap, &nHeap, (PathSearchEntry) { cost[N] + b[0].cost, N, 0 });
+    }
+
+    PathSearchEntry *d = &best[level*k];
+    while(nHeap > 0 && nBest[level] < k) {
+      PathSearchEntry e = pathSearchPop(heap, &nHeap);
+      d[nBest[level]++] = e;
+
+      const PathSearchEntry *b = &best[(level-e.N)*k];
+      if (e.rank+1 < nBest[level-e.N] && b[e.rank+1].cost < (1ULL << 60) - cost[e.N]) {
+	pathSearchPush(heap, &nHeap, (PathSearchEntry) { cost[e.N] + b[e.rank+1].cost, e.N, e.rank+1 });
+      }
+    }
+  }
+
+  const int nPath = nBest[nLevel];
+
+  for(int i=0;i<nPath;i++) {
+    int32_t *pa = &path[i*(nLevel+1)];
+    for(int level=0;level<=nLevel;level++) pa[level] = 0;
+    pathCost[i] = best[nLevel*k+i].cost;
+
+    for(int level=nLevel, rank=i;level > 0;) {
+      const PathSearchEntry *e = &best[level*k+rank];
+      pa[level] = e->N;
+      rank = e->rank;
+      level -= e->N;
+    }
+  }
+
+  free(heap);
+  free(cost);
+  free(nBest);
+  free(best);
+
+  return nPath;
+}
+
 uint32_t ilog2(uint32_t q) {
   static const uint32_t tab[] = {0,1,2,2,3,3,3,3,4,4,4,4,4,4,4,4};
   uint32_t r = 0,qq;
@@ -169,6 +806,13 @@ char *archID = NULL;
 uint64_t planMode = SLEEF_PLAN_REFERTOENVVAR;
 ArrayMap *planMap = NULL;
 int planFilePathSet = 0, planFileLoaded = 0;
+
+// Binary plan store. Entries put into planMap are also queued, and
+// appended to the file by savePlanToFile.
+PlanStore *planStore = NULL;
+int planStoreUsed = 0, planStoreCleared = 0;
+uint64_t *planStorePendingKey = NULL, *planStorePendingValue = NULL;
+int planStoreNPending = 0, planStorePendingCapacity = 0;
 #ifdef _OPENMP
 omp_lock_t planMapLock;
 int planMapLockInitialized = 0;
@@ -224,8 +868,19 @@ static void loadPlanFromFile() {
   }
 
   if (planMap != NULL) ArrayMap_dispose(planMap);
-  
-  if (dftPlanFilePath != NULL && (planMode & SLEEF_PLAN_RESET) == 0) {
+  planMap = NULL;
+
+  if (planStore != NULL) PlanStore_close(planStore);
+  planStore = NULL;
+  planStoreNPending = 0;
+  planStoreCleared = 0;
+
+  planStoreUsed = dftPlanFilePath != NULL &&
+    ((planMode & SLEEF_PLAN_BINARY) != 0 || PlanStore_isPlanStore(dftPlanFilePath));
+
+  if (planStoreUsed) {
+    if ((planMode & SLEEF_PLAN_RESET) == 0) planStore = PlanStore_open(dftPlanFilePath);
+  } else if (dftPlanFilePath != NULL && (planMode & SLEEF_PLAN_RESET) == 0) {
     planMap = ArrayMap_load(dftPlanFilePath, archID, PLANFILEID, (planMode & SLEEF_PLAN_NOLOCK) == 0);
   }
 
@@ -237,12 +892,23 @@ static void loadPlanFromFile() {
 static void savePlanToFile() {
   assert(planFileLoaded);
   if ((planMode & SLEEF_PLAN_READONLY) == 0 && dftPlanFilePath != NULL) {
-    ArrayMap_save(planMap, dftPlanFilePath, archID, PLANFILEID);
+    if (!planStoreUsed) {
+      ArrayMap_save(planMap, dftPlanFilePath, archID, PLANFILEID);
+      return;
+    }
+
+    uint64_t arch = PlanStore_hashString(archID);
+    if ((planMode & SLEEF_PLAN_RESET) != 0 && !planStoreCleared) {
+      PlanStore_compact(dftPlanFilePath, 1, arch);
+      planStoreCleared = 1;
+    }
+    PlanStore_append(dftPlanFilePath, arch, planStorePendingKey, planStorePendingValue, planStoreNPending);
+    planStoreNPending = 0;
   }
 }
 
 #define CATBIT 8
-#define BASETYPEIDBIT 2
+#define BASETYPEIDBIT 2 // Quad (4) is encoded as 0, which is otherwise unused
 #define LOG2LENBIT 8
 #define DIRBIT 1
 
@@ -302,9 +968,26 @@ static uint64_t keyPathConfig(int baseTypeID, int log2len, int dir, int level, i
   return k;
 }
 
+#define ISABIT 8
+#define MODELITEMBIT 16
+
+static uint64_t keyCostModel(int baseTypeID, int isa, int item) {
+  int cat = 5;
+  uint64_t k = 0;
+  k = (k << MODELITEMBIT) | (item & ~(~(uint64_t)0 << MODELITEMBIT));
+  k = (k << ISABIT) | (isa & ~(~(uint64_t)0 << ISABIT));
+  k = (k << BASETYPEIDBIT) | (baseTypeID & ~(~(uint64_t)0 << BASETYPEIDBIT));
+  k = (k << CATBIT) | (cat & ~(~(uint64_t)0 << CATBIT));
+  return k;
+}
+
 static uint64_t planMap_getU64(uint64_t key) {
   char *s = ArrayMap_get(planMap, key);
-  if (s == NULL) return 0;
+  if (s == NULL) {
+    uint64_t value;
+    if (planStore != NULL && PlanStore_get(planStore, PlanStore_hashString(archID), key, &value)) return value;
+    return 0;
+  }
   uint64_t ret;
   if (sscanf(s, "%" SCNx64, &ret) != 1) return 0;
   return ret;
@@ -315,10 +998,21 @@ static void planMap_putU64(uint64_t key, uint64_t value) {
   sprintf(s, "%" PRIx64, value);
   s = ArrayMap_put(planMap, key, s);
   if (s != NULL) free(s);
+
+  if (planStoreUsed) {
+    if (planStoreNPending >= planStorePendingCapacity) {
+      planStorePendingCapacity = planStorePendingCapacity == 0 ? 64 : planStorePendingCapacity * 2;
+      planStorePendingKey = realloc(planStorePendingKey, sizeof(uint64_t) * planStorePendingCapacity);
+      planStorePendingValue = realloc(planStorePendingValue, sizeof(uint64_t) * planStorePendingCapacity);
+    }
+    planStorePendingKey[planStoreNPending] = key;
+    planStorePendingValue[planStoreNPending] = value;
+    planStoreNPending++;
+  }
 }
 
 int PlanManager_loadMeasurementResultsP(SleefDFT *p, int pathCat) {
-  assert(p != NULL && (p->magic == MAGIC_FLOAT || p->magic == MAGIC_DOUBLE));
+  assert(p != NULL && is1DPlan(p));
 
   initPlanMapLock();
 
@@ -353,7 +1047,7 @@ int PlanManager_loadMeasurementResultsP(SleefDFT *p, int pathCat) {
 }
 
 void PlanManager_saveMeasurementResultsP(SleefDFT *p, int pathCat) {
-  assert(p != NULL && (p->magic == MAGIC_FLOAT || p->magic == MAGIC_DOUBLE));
+  assert(p != NULL && is1DPlan(p));
 
   initPlanMapLock();
 
@@ -384,7 +1078,7 @@ void PlanManager_saveMeasurementResultsP(SleefDFT *p, int pathCat) {
 }
 
 int PlanManager_loadMeasurementResultsT(SleefDFT *p) {
-  assert(p != NULL && (p->magic == MAGIC2D_FLOAT || p->magic == MAGIC2D_DOUBLE));
+  assert(p != NULL && is2DPlan(p));
 
   initPlanMapLock();
 
@@ -403,7 +1097,7 @@ int PlanManager_loadMeasurementResultsT(SleefDFT *p) {
 }
 
 void PlanManager_saveMeasurementResultsT(SleefDFT *p) {
-  assert(p != NULL && (p->magic == MAGIC2D_FLOAT || p->magic == MAGIC2D_DOUBLE));
+  assert(p != NULL && is2DPlan(p));
 
   initPlanMapLock();
 
@@ -421,3 +1115,183 @@ void PlanManager_saveMeasurementResultsT(SleefDFT *p) {
   omp_unset_lock(&planMapLock);
 #endif
 }
+
+int PlanManager_loadCostModel(int baseTypeID, int isa, uint64_t *model, int nItem) {
+  initPlanMapLock();
+
+#ifdef _OPENMP
+  omp_set_lock(&planMapLock);
+#endif
+  if (!planFileLoaded) loadPlanFromFile();
+
+  for(int i=0;i<nItem;i++) model[i] = planMap_getU64(keyCostModel(baseTypeID, isa, i));
+
+#ifdef _OPENMP
+  omp_unset_lock(&planMapLock);
+#endif
+  return model[0] != 0;
+}
+
+void PlanManager_saveCostModel(int baseTypeID, int isa, const uint64_t *model, int nItem) {
+  initPlanMapLock();
+
+#ifdef _OPENMP
+  omp_set_lock(&planMapLock);
+#endif
+  if (!planFileLoaded) loadPlanFromFile();
+
+  for(int i=0;i<nItem;i++) planMap_putU64(keyCostModel(baseTypeID, isa, i), model[i]);
+
+  if ((planMode & SLEEF_PLAN_READONLY) == 0) savePlanToFile();
+
+#ifdef _OPENMP
+  omp_unset_lock(&planMapLock);
+#endif
+}
+
+// Calibration takes a while, and it is only worthwhile if the result is kept in a plan file
+int PlanManager_costModelWritable() {
+  initPlanMapLock();
+
+#ifdef _OPENMP
+  omp_set_lock(&planMapLock);
+#endif
+  if (!planFileLoaded) loadPlanFromFile();
+
+  int ret = dftPlanFilePath != NULL && (planMode & SLEEF_PLAN_READONLY) == 0;
+
+#ifdef _OPENMP
+  omp_unset_lock(&planMapLock);
+#endif
+  return ret;
+}
+
+// In-memory plan export
+//
+// The exported image consists of a header, pairs of plan map key and
+// value, and a checksum of the pairs. The image is only meaningful on
+// a machine with the same architecture ID and byte order.
+
+#define PLANEXPORT_MAGIC "SLEEFPX"
+#define PLANEXPORT_VERSION 1
+#define PLANEXPORT_ENDIANCHECK UINT64_C(0x0102030405060708)
+
+typedef struct {
+  char magic[8];
+  uint32_t version, nEntries;
+  uint64_t arch, endianCheck;
+} PlanExportHeader;
+
+static uint64_t planExportChecksum(const uint64_t *kv, uint64_t n) {
+  uint64_t h = UINT64_C(0xcbf29ce484222325);
+  for(uint64_t i=0;i<n;i++) h = (h ^ kv[i]) * UINT64_C(0x100000001b3);
+  return h;
+}
+
+static uint64_t currentArch() {
+  return PlanStore_hashString(archID != NULL ? archID : Sleef_getCpuIdString());
+}
+
+EXPORT size_t SleefDFT_exportPlans(void *buf, size_t size) {
+  initPlanMapLock();
+
+#ifdef _OPENMP
+  omp_set_lock(&planMapLock);
+#endif
+  if (!planFileLoaded) loadPlanFromFile();
+
+  uint64_t arch = currentArch();
+
+  // Entries in the binary plan store come first so that the ones in
+  // planMap, which are newer, override them on import
+
+  int nStore = planStore != NULL ? PlanStore_list(planStore, arch, NULL, NULL, 0) : 0;
+  int nMap = ArrayMap_size(planMap);
+  uint64_t *kv = malloc(sizeof(uint64_t) * 2 * (nStore + nMap + 1));
+  uint64_t *sk = malloc(sizeof(uint64_t) * (nStore + 1)), *sv = malloc(sizeof(uint64_t) * (nStore + 1));
+  if (nStore > 0) PlanStore_list(planStore, arch, sk, sv, nStore);
+
+  int n = 0;
+  for(int i=0;i<nStore;i++) {
+    if (ArrayMap_get(planMap, sk[i]) != NULL) continue;
+    kv[n*2+0] = sk[i];
+    kv[n*2+1] = sv[i];
+    n++;
+  }
+
+  uint64_t *keys = ArrayMap_keyArray(planMap);
+  for(int i=0;i<nMap;i++) {
+    kv[n*2+0] = keys[i];
+    kv[n*2+1] = planMap_getU64(keys[i]);
+    n++;
+  }
+  free(keys);
+  free(sk);
+  free(sv);
+
+#ifdef _OPENMP
+  omp_unset_lock(&planMapLock);
+#endif
+
+  size_t required = sizeof(PlanExportHeader) + sizeof(uint64_t) * (2 * (size_t)n + 1);
+
+  if (buf != NULL && size >= required) {
+    PlanExportHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, PLANEXPORT_MAGIC, sizeof(PLANEXPORT_MAGIC));
+    h.version = PLANEXPORT_VERSION;
+    h.nEntries = n;
+    h.arch = arch;
+    h.endianCheck = PLANEXPORT_ENDIANCHECK;
+
+    uint64_t check = planExportChecksum(kv, 2 * (uint64_t)n);
+    memcpy(buf, &h, sizeof(h));
+    memcpy((char *)buf + sizeof(h), kv, sizeof(uint64_t) * 2 * n);
+    memcpy((char *)buf + sizeof(h) + sizeof(uint64_t) * 2 * n, &check, sizeof(check));
+  }
+
+  free(kv);
+
+  return required;
+}
+
+EXPORT int SleefDFT_importPlans(const void *buf, size_t size) {
+  PlanExportHeader h;
+  if (buf == NULL || size < sizeof(h)) return -1;
+  memcpy(&h, buf, sizeof(h));
+
+  if (memcmp(h.magic, PLANEXPORT_MAGIC, sizeof(PLANEXPORT_MAGIC)) != 0 ||
+      h.version != PLANEXPORT_VERSION || h.endianCheck != PLANEXPORT_ENDIANCHECK ||
+      (size - sizeof(h)) / (sizeof(uint64_t) * 2) < h.nEntries ||
+      size != sizeof(h) + sizeof(uint64_t) * (2 * (size_t)h.nEntries + 1)) return -1;
+
+  uint64_t *kv = malloc(sizeof(uint64_t) * (2 * (size_t)h.nEntries + 1)), check;
+  memcpy(kv, (const char *)buf + sizeof(h), sizeof(uint64_t) * 2 * (size_t)h.nEntries);
+  memcpy(&check, (const char *)buf + sizeof(h) + sizeof(uint64_t) * 2 * (size_t)h.nEntries, sizeof(check));
+
+  if (check != planExportChecksum(kv, 2 * (uint64_t)h.nEntries)) {
+    free(kv);
+    return -1;
+  }
+
+  initPlanMapLock();
+
+#ifdef _OPENMP
+  omp_set_lock(&planMapLock);
+#endif
+  if (!planFileLoaded) loadPlanFromFile();
+
+  int ret = -1;
+  if (h.arch == currentArch()) {
+    for(uint32_t i=0;i<h.nEntries;i++) planMap_putU64(kv[i*2+0], kv[i*2+1]);
+    ret = h.nEntries;
+  }
+
+#ifdef _OPENMP
+  omp_unset_lock(&planMapLock);
+#endif
+
+  free(kv);
+
+  return ret;
+}
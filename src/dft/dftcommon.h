@@ -9,12 +9,29 @@
 
 #define MAXLOG2LEN 32
 
+// A transform or a callback in an execution graph
+typedef struct SleefDFTGraphNode {
+  struct SleefDFT *plan;
+  const void *in;
+  void *out;
+  void (*func)(void *);
+  void *arg;
+  int32_t level;
+} SleefDFTGraphNode;
+
 typedef struct SleefDFT {
   uint32_t magic;
   uint64_t mode, mode2, mode3;
   int baseTypeID;
   const void *in;
   void *out;
+  uint64_t planDeadline;
+  int planTruncated;
+  void **hBuf;
+  int nHBuf;
+  void **rtPtr;
+  uint64_t *rtSize;
+  int nRt, rtPinned;
   
   union {
     struct {
@@ -35,6 +52,16 @@ typedef struct SleefDFT {
       uint64_t tm[CONFIGMAX][(MAXBUTWIDTH+1)*32];
       uint64_t bestTime;
       int16_t bestPath[32], bestPathConfig[32], pathLen;
+
+      void *asyncThread;
+      struct SleefDFT *asyncPlan;
+      int asyncPending;
+
+      const char *isaName;
+      int vectorBits;
+      uint64_t tmDivisor, estimatedTime, measuredTime;
+      uint64_t tableBytes, scratchBytes;
+      uint64_t stageTicks[MAXLOG2LEN+1], stageCalls[MAXLOG2LEN+1];
     };
 
     struct {
@@ -43,6 +70,44 @@ typedef struct SleefDFT {
       uint64_t tmNoMT, tmMT;
       struct SleefDFT *instH, *instV;
       void *tBuf;
+      uint64_t tBufBytes;
+    };
+
+    struct {
+      uint64_t oocLen, memLimit;
+      int32_t log2oocLen, log2oocRow, log2oocCol, log2oocTwLo;
+      int32_t log2oocBlock1, log2oocBlock2;
+      struct SleefDFT *instOocC, *instOocR;
+      void *oocTwLo, *oocTwHi;
+      int oocNThread;
+    };
+
+    struct {
+      uint32_t prLen, prIn, prOut;
+      int32_t log2prSub, prByInput, prNThread;
+      struct SleefDFT *instPr;
+      void *prTw, *prBuf;
+    };
+
+    struct {
+      uint32_t btLen, btCount;
+      int32_t btPaired, btNThread;
+      struct SleefDFT *instBtC, *instBtR;
+      void *btBuf;
+    };
+
+    struct {
+      uint32_t b2Count;
+      int32_t b2Across, b2NThread;
+      uint64_t b2Stride;
+      struct SleefDFT *inst2D;
+      void *b2Buf;
+    };
+
+    struct {
+      int32_t grCount, grCapacity, grNLevel, grNThread;
+      SleefDFTGraphNode *grNode;
+      int32_t *grOrder, *grLevelStart;
     };
   };
 } SleefDFT;
@@ -54,6 +119,23 @@ typedef struct SleefDFT {
 #define ENVVAR "SLEEFDFTPLAN"
 
 #define SLEEF_MODE_MEASUREBITS (3 << 20)
+#define SLEEF_MODE_EFFORTBITS (3 << 22)
+#define SLEEF_MODE_TIMEBUDGETBITS (~(uint64_t)0 << 32)
+#define SLEEF_MODE_NOCOSTMODEL (1 << 30)
+#define SLEEF_MODE_CONVBITS (SLEEF_MODE_FP16 | SLEEF_MODE_BF16 | SLEEF_MODE_INT16 | SLEEF_MODE_INT32)
+
+// Formats converted by the kernels for the first and the last stages,
+// and the post-processing of the output by the last stage
+#define CONV_NONE (-1)
+#define CONV_FP16 0
+#define CONV_BF16 1
+#define CONV_INT16 2
+#define CONV_INT32 3
+#define CONV_POWER 4
+#define CONV_MAGNITUDE 5
+#define CONV_POWERDB 6
+#define CONV_PHASE 7
+#define SLEEF_MODE_POSTBITS (7 << 4)
 
 void freeTables(SleefDFT *p);
 uint32_t ilog2(uint32_t q);
@@ -64,6 +146,30 @@ int PlanManager_loadMeasurementResultsT(SleefDFT *p);
 void PlanManager_saveMeasurementResultsT(SleefDFT *p);
 int PlanManager_loadMeasurementResultsP(SleefDFT *p, int pathCat);
 void PlanManager_saveMeasurementResultsP(SleefDFT *p, int pathCat);
+int PlanManager_loadCostModel(int baseTypeID, int isa, uint64_t *model, int nItem);
+void PlanManager_saveCostModel(int baseTypeID, int isa, const uint64_t *model, int nItem);
+int PlanManager_costModelWritable();
+
+typedef struct OutOfCoreFile OutOfCoreFile;
+
+OutOfCoreFile *OutOfCoreFile_open(const char *inPath, const char *outPath, uint64_t size);
+void OutOfCoreFile_close(OutOfCoreFile *f);
+int OutOfCoreFile_read(void *ctx, int target, uint64_t offset, void *buf, uint64_t size);
+int OutOfCoreFile_write(void *ctx, uint64_t offset, const void *buf, uint64_t size);
+
+void RealtimeMemory_lock(SleefDFT *p, void *ptr, uint64_t size);
+void RealtimeMemory_unlockAll(SleefDFT *p);
+void RealtimeThreads_pin(SleefDFT *p);
+void RealtimeThreads_unpin(SleefDFT *p);
+
+int PathSearch_kShortest(int nLevel, int maxN, uint64_t (*stageCost)(void *ctx, int level, int N), void *ctx,
+			 int k, int32_t *path, uint64_t *pathCost);
+
+void *BackgroundThread_start(void *(*func)(void *), void *arg);
+void BackgroundThread_join(void *thread);
+void *atomicLoadPtr(void **ptr);
+void atomicStorePtr(void **ptr, void *value);
+void atomicAddU64(uint64_t *ptr, uint64_t value);
 
 #define GETINT_VECWIDTH 100
 #define GETINT_DFTPRIORITY 101
@@ -0,0 +1,73 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Scalar conversions between float and the 16-bit floating point
+// formats, and to the integer formats. They are used by the conversion
+// kernels for the first and the last stages, and by the transforms
+// that are too small to have them.
+
+#ifndef __DFTCONV_H__
+#define __DFTCONV_H__
+
+#include <stdint.h>
+
+typedef union { float f; uint32_t u; } fu_t;
+
+static INLINE float fromFP16(uint16_t h) {
+  fu_t c, d;
+  c.u = (uint32_t)(h & 0x7fff) << 13;
+  d.u = (254 - 15) << 23;
+  c.f *= d.f; // Rebias the exponent, which also handles subnormals
+  if ((h & 0x7c00) == 0x7c00) c.u |= 0xff << 23;
+  c.u |= (uint32_t)(h & 0x8000) << 16;
+  return c.f;
+}
+
+static INLINE uint16_t toFP16(float f) {
+  fu_t c, m;
+  c.f = f;
+  const uint32_t sign = c.u & 0x80000000;
+  c.u ^= sign;
+
+  uint32_t o;
+  if (c.u >= (127 + 16) << 23) {
+    o = c.u > 0xff << 23 ? 0x7e00 : 0x7c00;
+  } else if (c.u < (127 - 14) << 23) {
+    // Adding 0.5 rounds the subnormal to nearest even in the low bits
+    m.u = 126 << 23;
+    c.f += m.f;
+    o = c.u - m.u;
+  } else {
+    o = (c.u + ((uint32_t)(15 - 127) << 23) + 0xfff + ((c.u >> 13) & 1)) >> 13;
+  }
+
+  return (uint16_t)(o | (sign >> 16));
+}
+
+static INLINE float fromBF16(uint16_t h) {
+  fu_t c;
+  c.u = (uint32_t)h << 16;
+  return c.f;
+}
+
+static INLINE uint16_t toBF16(float f) {
+  fu_t c;
+  c.f = f;
+  if ((c.u & 0x7fffffff) > 0x7f800000) return (uint16_t)((c.u >> 16) | 0x40);
+  return (uint16_t)((c.u + 0x7fff + ((c.u >> 16) & 1)) >> 16);
+}
+
+// Values are rounded to nearest with ties away from zero, and are
+// saturated. NaN is converted to 0.
+
+static INLINE int32_t toIntSat(double x, double minv, double maxv) {
+  x = x < 0 ? x - 0.5 : x + 0.5;
+  return x >= maxv ? (int32_t)maxv : x <= minv ? (int32_t)minv : x == x ? (int32_t)x : 0;
+}
+
+static INLINE int16_t toInt16(double x) { return (int16_t)toIntSat(x, INT16_MIN, INT16_MAX); }
+static INLINE int32_t toInt32(double x) { return toIntSat(x, INT32_MIN, INT32_MAX); }
+
+#endif // #ifndef __DFTCONV_H__
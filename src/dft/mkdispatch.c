@@ -12,6 +12,20 @@
 #error ENABLE_STREAM not defined
 #endif
 
+// Formats of the input and the output converted by the first and the
+// last stages. They are the same as in mkunroll.c. The formats from
+// CONVPOST on are the post-processing of the output.
+
+#define CONVMAX 8
+#define CONVPOST 4
+
+static const char *convName[CONVMAX] = { "fp16", "bf16", "int16", "int32", "power", "magnitude", "powerdb", "phase" };
+
+static int convAvailable(const char *basetype, int conv) {
+  if (conv >= 2) return strcmp(basetype, "float") == 0 || strcmp(basetype, "double") == 0;
+  return strcmp(basetype, "float") == 0;
+}
+
 int main(int argc, char **argv) {
   if (argc < 3) {
     fprintf(stderr, "Usage : %s <basetype> <unrollmax> <unrollmax2> <maxbutwidth> <isa> ...\n", argv[0]);
@@ -34,8 +48,12 @@ int main(int argc, char **argv) {
 
   if (strcmp(basetype, "paramonly") == 0) exit(0);
 
+  int nConv = 0;
+  for(int conv=0;conv<CONVMAX;conv++) nConv += convAvailable(basetype, conv);
+
   printf("#define ISAMAX %d\n", isamax);
   printf("#define CONFIGMAX 4\n");
+  if (nConv != 0) printf("#define CONVMAX %d\n", CONVMAX);
   
   for(int k=isastart;k<argc;k++) {
     for(int config=0;config<4;config++) {
@@ -49,10 +67,34 @@ int main(int argc, char **argv) {
 	printf("void tbut%db_%d_%s(real *, uint32_t *, const real *, const int, const real *, const int);\n", 1 << j, config, argv[k]);
 	printf("void but%df_%d_%s(real *, uint32_t *, const int, const real *, const int, const real *, const int);\n", 1 << j, config, argv[k]);
 	printf("void but%db_%d_%s(real *, uint32_t *, const int, const real *, const int, const real *, const int);\n", 1 << j, config, argv[k]);
+	if ((config & 1) != 0) continue;
+	printf("void dft%dfu_%d_%s(real *, const real *, const int);\n", 1 << j, config, argv[k]);
+	printf("void dft%dbu_%d_%s(real *, const real *, const int);\n", 1 << j, config, argv[k]);
+	printf("void tbut%dfu_%d_%s(real *, uint32_t *, const real *, const int, const real *, const int);\n", 1 << j, config, argv[k]);
+	printf("void tbut%dbu_%d_%s(real *, uint32_t *, const real *, const int, const real *, const int);\n", 1 << j, config, argv[k]);
+	for(int conv=0;conv<CONVMAX;conv++) {
+	  if (!convAvailable(basetype, conv)) continue;
+	  printf("void dft%df_%s_%d_%s(void *, const real *, const int, const real);\n", 1 << j, convName[conv], config, argv[k]);
+	  if (j != 1) printf("void dft%db_%s_%d_%s(void *, const real *, const int, const real);\n", 1 << j, convName[conv], config, argv[k]);
+	  if (conv >= CONVPOST) continue;
+	  printf("void tbut%df_%s_%d_%s(real *, uint32_t *, const void *, const int, const real *, const int, const real);\n", 1 << j, convName[conv], config, argv[k]);
+	  printf("void tbut%db_%s_%d_%s(real *, uint32_t *, const void *, const int, const real *, const int, const real);\n", 1 << j, convName[conv], config, argv[k]);
+	}
+      }
+    }
+    for(int conv=0;conv<CONVMAX;conv++) {
+      if (!convAvailable(basetype, conv)) continue;
+      printf("void realSub0_%s_%s(void *, const real *, const int, const real *, const real *, const int, const real);\n", convName[conv], argv[k]);
+      if (conv >= CONVPOST) {
+	printf("void postInPlace_%s_%s(real *, const int);\n", convName[conv], argv[k]);
+      } else {
+	printf("void realSub1_%s_%s(real *, const void *, const int, const real *, const real *, const int, const real);\n", convName[conv], argv[k]);
       }
     }
     printf("void realSub0_%s(real *, const real *, const int, const real *, const real *);\n", argv[k]);
     printf("void realSub1_%s(real *, const real *, const int, const real *, const real *, const int);\n", argv[k]);
+    printf("void realSub0u_%s(real *, const real *, const int, const real *, const real *);\n", argv[k]);
+    printf("void realSub1u_%s(real *, const real *, const int, const real *, const real *, const int);\n", argv[k]);
     printf("int getInt_%s(int);\n", argv[k]);
     printf("const void *getPtr_%s(int);\n", argv[k]);
   }
@@ -171,6 +213,106 @@ int main(int argc, char **argv) {
   }
   printf("};\n\n");
 
+  // Unaligned variants. Streaming stores are not used for unaligned buffers.
+
+  const char *uname[] = { "dft%dfu_%d_%s, ", "dft%dbu_%d_%s, ", "tbut%dfu_%d_%s, ", "tbut%dbu_%d_%s, " };
+  const char *utable[] = {
+    "void (*dftfu_%s[CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(real *, const real *, const int) = {\n",
+    "void (*dftbu_%s[CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(real *, const real *, const int) = {\n",
+    "void (*tbutfu_%s[CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(real *, uint32_t *, const real *, const int, const real *, const int) = {\n",
+    "void (*tbutbu_%s[CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(real *, uint32_t *, const real *, const int, const real *, const int) = {\n",
+  };
+
+  for(int u=0;u<4;u++) {
+    printf(utable[u], basetype);
+    for(int config=0;config<4;config++) {
+      printf("  {\n");
+      for(int k=isastart;k<argc;k++) {
+	printf("    {NULL, ");
+	for(int i=1;i<=maxbutwidth;i++) {
+	  // dftb for the radix 2 is the same as dftf
+	  if (u == 1 && i == 1) {
+	    printf(uname[0], 1 << i, config & ~1, argv[k]);
+	  } else {
+	    printf(uname[u], 1 << i, config & ~1, argv[k]);
+	  }
+	}
+	printf("},\n");
+      }
+      printf("},\n");
+    }
+    printf("};\n\n");
+  }
+
+  // Variants that convert the input of the first stage or the output
+  // of the last stage. Streaming stores are not used for them either.
+
+  const char *xname[] = { "dft%df_%s_%d_%s, ", "dft%db_%s_%d_%s, ", "tbut%df_%s_%d_%s, ", "tbut%db_%s_%d_%s, " };
+  const char *xtable[] = {
+    "void (*dftfx_%s[CONVMAX][CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(void *, const real *, const int, const real) = {\n",
+    "void (*dftbx_%s[CONVMAX][CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(void *, const real *, const int, const real) = {\n",
+    "void (*tbutfx_%s[CONVMAX][CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(real *, uint32_t *, const void *, const int, const real *, const int, const real) = {\n",
+    "void (*tbutbx_%s[CONVMAX][CONFIGMAX][ISAMAX][MAXBUTWIDTH+1])(real *, uint32_t *, const void *, const int, const real *, const int, const real) = {\n",
+  };
+
+  for(int x=0;nConv != 0 && x<4;x++) {
+    printf(xtable[x], basetype);
+    for(int conv=0;conv<CONVMAX;conv++) {
+      printf("  {\n");
+      for(int config=0;config<4;config++) {
+	printf("    {\n");
+	for(int k=isastart;k<argc;k++) {
+	  printf("      {NULL, ");
+	  for(int i=1;i<=maxbutwidth;i++) {
+	    if (!convAvailable(basetype, conv) || (x >= 2 && conv >= CONVPOST)) {
+	      printf("NULL, ");
+	    } else if (x == 1 && i == 1) {
+	      printf(xname[0], 1 << i, convName[conv], config & ~1, argv[k]);
+	    } else {
+	      printf(xname[x], 1 << i, convName[conv], config & ~1, argv[k]);
+	    }
+	  }
+	  printf("},\n");
+	}
+	printf("    },\n");
+      }
+      printf("  },\n");
+    }
+    printf("};\n\n");
+  }
+
+  if (nConv != 0) {
+    printf("void (*realSub0x_%s[CONVMAX][ISAMAX])(void *, const real *, const int, const real *, const real *, const int, const real) = {\n", basetype);
+    for(int conv=0;conv<CONVMAX;conv++) {
+      printf("  { ");
+      for(int k=isastart;k<argc;k++) {
+	if (convAvailable(basetype, conv)) printf("realSub0_%s_%s, ", convName[conv], argv[k]); else printf("NULL, ");
+      }
+      printf("},\n");
+    }
+    printf("};\n\n");
+
+    printf("void (*realSub1x_%s[CONVMAX][ISAMAX])(real *, const void *, const int, const real *, const real *, const int, const real) = {\n", basetype);
+    for(int conv=0;conv<CONVMAX;conv++) {
+      printf("  { ");
+      for(int k=isastart;k<argc;k++) {
+	if (convAvailable(basetype, conv) && conv < CONVPOST) printf("realSub1_%s_%s, ", convName[conv], argv[k]); else printf("NULL, ");
+      }
+      printf("},\n");
+    }
+    printf("};\n\n");
+
+    printf("void (*postInPlacex_%s[CONVMAX][ISAMAX])(real *, const int) = {\n", basetype);
+    for(int conv=0;conv<CONVMAX;conv++) {
+      printf("  { ");
+      for(int k=isastart;k<argc;k++) {
+	if (convAvailable(basetype, conv) && conv >= CONVPOST) printf("postInPlace_%s_%s, ", convName[conv], argv[k]); else printf("NULL, ");
+      }
+      printf("},\n");
+    }
+    printf("};\n\n");
+  }
+
   //
 
   printf("void (*realSub0_%s[ISAMAX])(real *, const real *, const int, const real *, const real *) = {\n  ", basetype);
@@ -181,6 +323,14 @@ int main(int argc, char **argv) {
   for(int k=isastart;k<argc;k++) printf("realSub1_%s, ", argv[k]);
   printf("\n};\n\n");
 
+  printf("void (*realSub0u_%s[ISAMAX])(real *, const real *, const int, const real *, const real *) = {\n  ", basetype);
+  for(int k=isastart;k<argc;k++) printf("realSub0u_%s, ", argv[k]);
+  printf("\n};\n\n");
+
+  printf("void (*realSub1u_%s[ISAMAX])(real *, const real *, const int, const real *, const real *, const int) = {\n  ", basetype);
+  for(int k=isastart;k<argc;k++) printf("realSub1u_%s, ", argv[k]);
+  printf("\n};\n\n");
+
   printf("int (*getInt_%s[16])(int) = {\n  ", basetype);
   for(int k=isastart;k<argc;k++) printf("getInt_%s, ", argv[k]);
   for(int k=0;k<16-(argc-isastart);k++) printf("NULL, ");
@@ -0,0 +1,148 @@
+//   Copyright Naoki Shibata and contributors 2010 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Generates sleefdftinline.h, which contains complex transforms of
+// fixed sizes that are called without a plan. Each transform of n
+// points is split into transforms of n/R points and a radix-R
+// butterfly, where R is chosen when the header is generated.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static const char *types[] = { "double", "float" };
+
+static int log2radix;
+
+static int subLog2(int log2n) { return log2n <= log2radix ? 0 : log2n - log2radix; }
+
+// Radix-2 or radix-4 butterfly of a0..a(R-1) into y0..y(R-1)
+
+static void butterfly(const char *t, int r, int backward, const char *indent) {
+  if (r == 2) {
+    printf("%sconst %s y0r = a0r + a1r, y0i = a0i + a1i, y1r = a0r - a1r, y1i = a0i - a1i;\n", indent, t);
+    return;
+  }
+
+  printf("%sconst %s t0r = a0r + a2r, t0i = a0i + a2i, t1r = a0r - a2r, t1i = a0i - a2i;\n", indent, t);
+  printf("%sconst %s t2r = a1r + a3r, t2i = a1i + a3i, t3r = a1r - a3r, t3i = a1i - a3i;\n", indent, t);
+  printf("%sconst %s y0r = t0r + t2r, y0i = t0i + t2i, y2r = t0r - t2r, y2i = t0i - t2i;\n", indent, t);
+  if (!backward) {
+    printf("%sconst %s y1r = t1r + t3i, y1i = t1i - t3r, y3r = t1r - t3i, y3i = t1i + t3r;\n", indent, t);
+  } else {
+    printf("%sconst %s y1r = t1r - t3i, y1i = t1i + t3r, y3r = t1r + t3i, y3i = t1i - t3r;\n", indent, t);
+  }
+}
+
+static void emitTable(const char *t, int log2n) {
+  const int n = 1 << log2n, r = 1 << (log2n - subLog2(log2n)), m = n / r;
+
+  printf("static const %s sleefdft_%s_tw%d[] = {\n", t, t, n);
+  for(int k=0;k<m;k++) {
+    printf("  ");
+    for(int j=1;j<r;j++) {
+      // Multiples of pi/2 are written exactly
+
+      const int q = (j * k) % n;
+      if ((q * 4) % n == 0) {
+	static const char *c[] = { "1, 0", "0, -1", "-1, 0", "0, 1" };
+	printf("%s, ", c[q * 4 / n]);
+      } else {
+	const long double a = -2 * 3.14159265358979323846264338327950288L * q / n;
+	const char *sfx = t[0] == 'f' ? "f" : "";
+	printf("%.21Lg%s, %.21Lg%s, ", cosl(a), sfx, sinl(a), sfx);
+      }
+    }
+    printf("\n");
+  }
+  printf("};\n\n");
+}
+
+static void emitTransform(const char *t, int log2n, int backward) {
+  const int n = 1 << log2n, sub = subLog2(log2n), r = 1 << (log2n - sub), m = 1 << sub;
+  const char d = backward ? 'b' : 'f';
+
+  printf("static inline void sleefdft_%s_%c%d(%s *out, const %s *in, int is) {\n", t, d, n, t, t);
+
+  if (sub == 0) {
+    for(int j=0;j<r;j++) printf("  const %s a%dr = in[%d*is+0], a%di = in[%d*is+1];\n", t, j, j*2, j, j*2);
+    butterfly(t, r, backward, "  ");
+    for(int j=0;j<r;j++) printf("  out[%d] = y%dr; out[%d] = y%di;\n", j*2, j, j*2+1, j);
+    printf("}\n\n");
+    return;
+  }
+
+  for(int j=0;j<r;j++) printf("  sleefdft_%s_%c%d(out + %d, in + %d*is, is*%d);\n", t, d, m, j*m*2, j*2, r);
+  printf("\n");
+
+  // The first butterfly has no twiddle factors
+
+  printf("  {\n");
+  for(int j=0;j<r;j++) printf("    const %s a%dr = out[%d], a%di = out[%d];\n", t, j, j*m*2, j, j*m*2+1);
+  butterfly(t, r, backward, "    ");
+  for(int j=0;j<r;j++) printf("    out[%d] = y%dr; out[%d] = y%di;\n", j*m*2, j, j*m*2+1, j);
+  printf("  }\n\n");
+
+  printf("  for(int k=1;k<%d;k++) {\n", m);
+  printf("    const %s *w = sleefdft_%s_tw%d + k*%d;\n", t, t, n, (r-1)*2);
+  printf("    const %s a0r = out[k*2+0], a0i = out[k*2+1];\n", t);
+  for(int j=1;j<r;j++) {
+    printf("    const %s b%dr = out[(k+%d)*2+0], b%di = out[(k+%d)*2+1];\n", t, j, j*m, j, j*m);
+    if (!backward) {
+      printf("    const %s a%dr = b%dr * w[%d] - b%di * w[%d], a%di = b%dr * w[%d] + b%di * w[%d];\n",
+	     t, j, j, (j-1)*2, j, (j-1)*2+1, j, j, (j-1)*2+1, j, (j-1)*2);
+    } else {
+      printf("    const %s a%dr = b%dr * w[%d] + b%di * w[%d], a%di = b%di * w[%d] - b%dr * w[%d];\n",
+	     t, j, j, (j-1)*2, j, (j-1)*2+1, j, j, (j-1)*2, j, (j-1)*2+1);
+    }
+  }
+  butterfly(t, r, backward, "    ");
+  for(int j=0;j<r;j++) printf("    out[(k+%d)*2+0] = y%dr; out[(k+%d)*2+1] = y%di;\n", j*m, j, j*m, j);
+  printf("  }\n");
+  printf("}\n\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "Usage : %s <maxlog2len> <log2radix>\n", argv[0]);
+    exit(-1);
+  }
+
+  const int maxlog2len = atoi(argv[1]);
+  log2radix = atoi(argv[2]);
+
+  if (maxlog2len < 2 || maxlog2len > 16 || log2radix < 1 || log2radix > 2) {
+    fprintf(stderr, "%s : maxlog2len must be 2 to 16, and log2radix must be 1 or 2\n", argv[0]);
+    exit(-1);
+  }
+
+  printf("// This file is generated by mkinline. Do not edit.\n\n");
+  printf("#ifndef __SLEEFDFTINLINE_H__\n");
+  printf("#define __SLEEFDFTINLINE_H__\n\n");
+  printf("#define SLEEFDFT_INLINE_MAXLOG2LEN %d\n\n", maxlog2len);
+
+  for(int i=0;i<2;i++) {
+    const char *t = types[i];
+
+    for(int log2n=1;log2n<=maxlog2len;log2n++) {
+      if (subLog2(log2n) != 0) emitTable(t, log2n);
+      emitTransform(t, log2n, 0);
+      emitTransform(t, log2n, 1);
+    }
+
+    for(int log2n=2;log2n<=maxlog2len;log2n++) {
+      printf("static inline void SleefDFT_%s_inlinef%d(%s *out, const %s *in) { sleefdft_%s_f%d(out, in, 1); }\n", t, 1 << log2n, t, t, t, 1 << log2n);
+      printf("static inline void SleefDFT_%s_inlineb%d(%s *out, const %s *in) { sleefdft_%s_b%d(out, in, 1); }\n", t, 1 << log2n, t, t, t, 1 << log2n);
+    }
+    printf("\n");
+
+    printf("#define SleefDFT_%s_inlinef(n, out, in) SleefDFT_%s_inlinef ## n (out, in)\n", t, t);
+    printf("#define SleefDFT_%s_inlineb(n, out, in) SleefDFT_%s_inlineb ## n (out, in)\n\n", t, t);
+  }
+
+  printf("#endif // #ifndef __SLEEFDFTINLINE_H__\n");
+
+  exit(0);
+}
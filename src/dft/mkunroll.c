@@ -7,9 +7,40 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <ctype.h>
 
 #define CONFIGMAX 4
 
+// Formats of the input and the output converted by the first and the
+// last stages, in the order of CONV_FP16 and the following in dftcommon.h.
+// The formats with post set are only for the output, and replace each
+// bin with a real value computed from it.
+
+#define CONVMAX 8
+
+static const struct {
+  const char *name, *type, *load, *store, *store1, *toReal, *fromReal;
+  int post;
+} convFormat[CONVMAX] = {
+  { "fp16", "uint16_t", "loadfp16(ptr, offset)", "storefp16(ptr, offset, v)",
+    "((ptr)[(k)*2+0] = FROMREALX(re), (ptr)[(k)*2+1] = FROMREALX(im))", "fromFP16(x)", "toFP16(x)", 0 },
+  { "bf16", "uint16_t", "loadbf16(ptr, offset)", "storebf16(ptr, offset, v)",
+    "((ptr)[(k)*2+0] = FROMREALX(re), (ptr)[(k)*2+1] = FROMREALX(im))", "fromBF16(x)", "toBF16(x)", 0 },
+  { "int16", "int16_t", "loadint16(ptr, offset, scale)", "storeint16(ptr, offset, v, scale)",
+    "((ptr)[(k)*2+0] = FROMREALX(re), (ptr)[(k)*2+1] = FROMREALX(im))", "((x) * scale)", "toInt16((x) * scale)", 0 },
+  { "int32", "int32_t", "loadint32(ptr, offset, scale)", "storeint32(ptr, offset, v, scale)",
+    "((ptr)[(k)*2+0] = FROMREALX(re), (ptr)[(k)*2+1] = FROMREALX(im))", "((x) * scale)", "toInt32((x) * scale)", 0 },
+  { "power", "real", NULL, "storepower(ptr, offset, v)", "((ptr)[k] = powervalue(re, im))", NULL, NULL, 1 },
+  { "magnitude", "real", NULL, "storemagnitude(ptr, offset, v)", "((ptr)[k] = magnitudevalue(re, im))", NULL, NULL, 1 },
+  { "powerdb", "real", NULL, "storepowerdb(ptr, offset, v)", "((ptr)[k] = powerdbvalue(re, im))", NULL, NULL, 1 },
+  { "phase", "real", NULL, "storephase(ptr, offset, v)", "((ptr)[k] = phasevalue(re, im))", NULL, NULL, 1 },
+};
+
+static int convAvailable(const char *baseType, int conv) {
+  if (conv >= 2) return strcmp(baseType, "float") == 0 || strcmp(baseType, "double") == 0;
+  return strcmp(baseType, "float") == 0;
+}
+
 char *replaceAll(const char *in, const char *pat, const char *replace) {
   const int replaceLen = (int)strlen(replace);
   const int patLen = (int)strlen(pat);
@@ -63,7 +94,7 @@ int main(int argc, char **argv) {
       sprintf(line, "unroll_%d_%s.c", config, isaString);
       FILE *fpout = fopen(line, "w");
       fputs("#include \"vectortype.h\"\n\n", fpout);
-      fprintf(fpout, "extern %s ctbl_%s[];\n", baseType, baseType);
+      fprintf(fpout, "extern real ctbl_%s[];\n", baseType);
       fprintf(fpout, "#define ctbl ctbl_%s\n\n", baseType);
 
       for(;;) {
@@ -98,6 +129,146 @@ int main(int argc, char **argv) {
       }
     
       fclose(fpin);
+
+      // Variants of the kernels for the first and the last stages,
+      // which accept input and output buffers not aligned to vectors
+
+      if ((config & 1) == 0) {
+	fpin = fopen("unroll0.org", "r");
+	int emit = 0;
+
+	for(;;) {
+	  if (fgets(line, LEN, fpin) == NULL) break;
+
+	  if (isalpha((int)line[0])) {
+	    emit = strncmp(line, "ALIGNED(8192) void dft", 22) == 0 ||
+	      strncmp(line, "ALIGNED(8192) void tbut", 23) == 0 ||
+	      strncmp(line, "ALIGNED(8192) void realSub", 26) == 0;
+	  }
+	  if (!emit && (line[0] != '#' || strncmp(line, "#pragma", 7) == 0)) continue;
+
+	  char configuString[16];
+	  sprintf(configuString, "u_%d_", config);
+
+	  const char *pat[][2] = {
+	    { "_%CONFIG%_", configuString }, { "realSub0_", "realSub0u_" }, { "realSub1_", "realSub1u_" },
+	    { "load(in,", "loadu(in," }, { "store(out,", "storeu(out," }, { "load (", "loadu(" }, { "store (", "storeu(" },
+	  };
+
+	  char *s = replaceAll(line, "%ISA%", isaString);
+	  for(int i=0;i<(int)(sizeof(pat)/sizeof(pat[0]));i++) {
+	    char *s0 = replaceAll(s, pat[i][0], pat[i][1]);
+	    free(s);
+	    s = s0;
+	  }
+
+	  if ((config & 2) == 0) {
+	    char *s0 = replaceAll(s, "#pragma", "//");
+	    free(s);
+	    s = s0;
+	  }
+
+	  if (config == 0) {
+	    char *s0 = replaceAll(s, "#undef EMITREALSUB", "#define EMITREALSUB");
+	    free(s);
+	    s = s0;
+	  }
+
+	  fputs(s, fpout);
+	  free(s);
+	}
+
+	fclose(fpin);
+      }
+
+      // Variants of the kernels for the first and the last stages,
+      // which convert the input or the output from or to other
+      // formats while loading or storing it. tbut is the first stage
+      // and dft is the last stage of the paths with two or more stages.
+
+      if ((config & 1) == 0) {
+	for(int conv=0;conv<CONVMAX;conv++) {
+	  if (!convAvailable(baseType, conv)) continue;
+
+	  fprintf(fpout, "\n#define XTYPE %s\n", convFormat[conv].type);
+	  if (convFormat[conv].load != NULL) fprintf(fpout, "#define LOADX(ptr, offset) %s\n", convFormat[conv].load);
+	  fprintf(fpout, "#define STOREX(ptr, offset, v) %s\n", convFormat[conv].store);
+	  fprintf(fpout, "#define STORE1X(ptr, k, re, im) %s\n", convFormat[conv].store1);
+	  if (convFormat[conv].toReal != NULL) fprintf(fpout, "#define TOREALX(x) %s\n", convFormat[conv].toReal);
+	  if (convFormat[conv].fromReal != NULL) fprintf(fpout, "#define FROMREALX(x) %s\n", convFormat[conv].fromReal);
+	  if (convFormat[conv].post) fprintf(fpout, "#define POSTX\n");
+	  fputs("\n", fpout);
+
+	  fpin = fopen("unroll0.org", "r");
+	  int emit = 0;
+
+	  for(;;) {
+	    if (fgets(line, LEN, fpin) == NULL) break;
+
+	    if (isalpha((int)line[0])) {
+	      emit = 0;
+	      // The post-processing formats have the last stage, realSub0x
+	      // and postInPlacex, and the other formats have all but postInPlacex
+	      const int post = convFormat[conv].post;
+	      if (strncmp(line, "ALIGNED(8192) void tbut", 23) == 0 && !post) emit = 1;
+	      if (strncmp(line, "ALIGNED(8192) void dft", 22) == 0) emit = 2;
+	      if (strncmp(line, "ALIGNED(8192) void realSub0x", 28) == 0 ||
+		  (strncmp(line, "ALIGNED(8192) void realSub1x", 28) == 0 && !post) ||
+		  (strncmp(line, "ALIGNED(8192) void postInPlacex", 31) == 0 && post)) emit = 3;
+	    }
+	    if (!emit && (line[0] != '#' || strncmp(line, "#pragma", 7) == 0)) continue;
+
+	    char configxString[32], realSub0xString[32], realSub1xString[32], postInPlacexString[32];
+	    sprintf(configxString, "_%s_%d_", convFormat[conv].name, config);
+	    sprintf(realSub0xString, "realSub0_%s_", convFormat[conv].name);
+	    sprintf(realSub1xString, "realSub1_%s_", convFormat[conv].name);
+	    sprintf(postInPlacexString, "postInPlace_%s_", convFormat[conv].name);
+
+	    const char *pat[][2] = {
+	      // The input of the first stage
+	      { "const real *RESTRICT in0", emit == 1 ? "const void *RESTRICT in0" : NULL },
+	      { "const real *in = in0", emit == 1 ? "const XTYPE *in = (const XTYPE *)in0" : NULL },
+	      { "load(in,", emit == 1 ? "LOADX(in," : NULL },
+	      { "const int K) {", emit == 1 ? "const int K, const real scale) {" : NULL },
+	      // The output of the last stage
+	      { "real *RESTRICT out0", emit == 2 ? "void *RESTRICT out0" : NULL },
+	      { "real *out = out0 + i0*2", emit == 2 ? (convFormat[conv].post ? "XTYPE *out = (XTYPE *)out0 + i0" : "XTYPE *out = (XTYPE *)out0 + i0*2") : NULL },
+	      { "store(out,", emit == 2 ? "STOREX(out," : NULL },
+	      { "const int shift) {", emit == 2 ? "const int shift, const real scale) {" : NULL },
+	      { "_%CONFIG%_", configxString }, { "realSub0x_", realSub0xString }, { "realSub1x_", realSub1xString },
+	      { "postInPlacex_", postInPlacexString },
+	    };
+
+	    char *s = replaceAll(line, "%ISA%", isaString);
+	    for(int i=0;i<(int)(sizeof(pat)/sizeof(pat[0]));i++) {
+	      if (pat[i][1] == NULL) continue;
+	      char *s0 = replaceAll(s, pat[i][0], pat[i][1]);
+	      free(s);
+	      s = s0;
+	    }
+
+	    if ((config & 2) == 0) {
+	      char *s0 = replaceAll(s, "#pragma", "//");
+	      free(s);
+	      s = s0;
+	    }
+
+	    if (config == 0) {
+	      char *s0 = replaceAll(s, "#undef EMITCONVREALSUB", "#define EMITCONVREALSUB");
+	      free(s);
+	      s = s0;
+	    }
+
+	    fputs(s, fpout);
+	    free(s);
+	  }
+
+	  fclose(fpin);
+
+	  fputs("\n#undef XTYPE\n#undef LOADX\n#undef STOREX\n#undef STORE1X\n#undef TOREALX\n#undef FROMREALX\n#undef POSTX\n", fpout);
+	}
+      }
+
       fclose(fpout);
     }
   }
@@ -9,6 +9,15 @@
 #include <math.h>
 #include "sleef.h"
 
+#if BASETYPEID == 3
+#define ENABLE_LONGDOUBLE
+#elif BASETYPEID == 4
+#define ENABLE_LONGDOUBLE
+#define ENABLEFLOAT128
+#define Sleef_quad2_DEFINED
+#include "quaddef.h"
+#endif
+
 #ifdef ENABLE_SSE2
 #include "helpersse2.h"
 #endif
@@ -53,6 +62,15 @@
 #include "helpers390x_128.h"
 #endif
 
+#if defined(ENABLE_RVVM1) || defined(ENABLE_RVVM2)
+#if BASETYPEID == 1
+#define ENABLE_RVV_DP
+#else
+#define ENABLE_RVV_SP
+#endif
+#include "helperrvv.h"
+#endif
+
 #ifdef ENABLE_VECEXT
 #include "helpervecext.h"
 #endif
@@ -133,9 +151,253 @@ static INLINE void stream(real *ptr, int offset, real2 v) { vstream_v_p_vf(&ptr[
 static INLINE void scatter(real *ptr, int offset, int step, real2 v) { vscatter2_v_p_i_i_vf(ptr, offset, step, v); }
 static INLINE void scstream(real *ptr, int offset, int step, real2 v) { vsscatter2_v_p_i_i_vf(ptr, offset, step, v); }
 
+static INLINE void prefetch(real *ptr, int offset) { vprefetch_v_p(&ptr[2*offset]); }
+#elif BASETYPEID == 3
+#define LOG2VECWIDTH (LOG2VECTLENDP-1)
+#define VECWIDTH (1 << LOG2VECWIDTH)
+
+typedef long double real;
+typedef vlongdouble real2;
+
+static int available(int name) { return vavailability_i(name); }
+
+static INLINE real2 uminus(real2 d0) { return vneg_vl_vl(d0); }
+static INLINE real2 uplusminus(real2 d0) { return vposneg_vl_vl(d0); }
+static INLINE real2 uminusplus(real2 d0) { return vnegpos_vl_vl(d0); }
+
+static INLINE real2 plus(real2 d0, real2 d1) { return vadd_vl_vl_vl(d0, d1); }
+static INLINE real2 minus(real2 d0, real2 d1) { return vsub_vl_vl_vl(d0, d1); }
+static INLINE real2 minusplus(real2 d0, real2 d1) { return vsubadd_vl_vl_vl(d0, d1); }
+static INLINE real2 times(real2 d0, real2 d1) { return vmul_vl_vl_vl(d0, d1); }
+static INLINE real2 timesminusplus(real2 d0, real2 d2, real2 d1) { return vmlsubadd_vl_vl_vl_vl(d0, d2, d1); }
+static INLINE real2 ctimes(real2 d0, real d) { return vmul_vl_vl_vl(d0, vcast_vl_l(d)); }
+static INLINE real2 ctimesminusplus(real2 d0, real c, real2 d1) { return vmlsubadd_vl_vl_vl_vl(d0, vcast_vl_l(c), d1); }
+
+static INLINE real2 reverse(real2 d0) { return vrev21_vl_vl(d0); }
+static INLINE real2 reverse2(real2 d0) { return vreva2_vl_vl(d0); }
+
+static INLINE real2 loadc(real c) { return vcast_vl_l(c); }
+
+static INLINE real2 load(const real *ptr, int offset) { return vload_vl_p(&ptr[2*offset]); }
+static INLINE real2 loadu(const real *ptr, int offset) { return vloadu_vl_p(&ptr[2*offset]); }
+static INLINE void store(real *ptr, int offset, real2 v) { vstore_v_p_vl(&ptr[2*offset], v); }
+static INLINE void storeu(real *ptr, int offset, real2 v) { vstoreu_v_p_vl(&ptr[2*offset], v); }
+static INLINE void stream(real *ptr, int offset, real2 v) { vstream_v_p_vl(&ptr[2*offset], v); }
+static INLINE void scatter(real *ptr, int offset, int step, real2 v) { vscatter2_v_p_i_i_vl(ptr, offset, step, v); }
+static INLINE void scstream(real *ptr, int offset, int step, real2 v) { vsscatter2_v_p_i_i_vl(ptr, offset, step, v); }
+
+static INLINE void prefetch(real *ptr, int offset) { vprefetch_v_p(&ptr[2*offset]); }
+#elif BASETYPEID == 4
+#define LOG2VECWIDTH (LOG2VECTLENDP-1)
+#define VECWIDTH (1 << LOG2VECWIDTH)
+
+typedef Sleef_quad real;
+typedef vquad real2;
+
+static int available(int name) { return vavailability_i(name); }
+
+static INLINE real2 uminus(real2 d0) { return vneg_vq_vq(d0); }
+static INLINE real2 uplusminus(real2 d0) { return vposneg_vq_vq(d0); }
+static INLINE real2 uminusplus(real2 d0) { return vnegpos_vq_vq(d0); }
+
+static INLINE real2 plus(real2 d0, real2 d1) { return vadd_vq_vq_vq(d0, d1); }
+static INLINE real2 minus(real2 d0, real2 d1) { return vsub_vq_vq_vq(d0, d1); }
+static INLINE real2 minusplus(real2 d0, real2 d1) { return vsubadd_vq_vq_vq(d0, d1); }
+static INLINE real2 times(real2 d0, real2 d1) { return vmul_vq_vq_vq(d0, d1); }
+static INLINE real2 timesminusplus(real2 d0, real2 d2, real2 d1) { return vmlsubadd_vq_vq_vq_vq(d0, d2, d1); }
+static INLINE real2 ctimes(real2 d0, real d) { return vmul_vq_vq_vq(d0, vcast_vq_q(d)); }
+static INLINE real2 ctimesminusplus(real2 d0, real c, real2 d1) { return vmlsubadd_vq_vq_vq_vq(d0, vcast_vq_q(c), d1); }
+
+static INLINE real2 reverse(real2 d0) { return vrev21_vq_vq(d0); }
+static INLINE real2 reverse2(real2 d0) { return vreva2_vq_vq(d0); }
+
+static INLINE real2 loadc(real c) { return vcast_vq_q(c); }
+
+static INLINE real2 load(const real *ptr, int offset) { return vload_vq_p(&ptr[2*offset]); }
+static INLINE real2 loadu(const real *ptr, int offset) { return vloadu_vq_p(&ptr[2*offset]); }
+static INLINE void store(real *ptr, int offset, real2 v) { vstore_v_p_vq(&ptr[2*offset], v); }
+static INLINE void storeu(real *ptr, int offset, real2 v) { vstoreu_v_p_vq(&ptr[2*offset], v); }
+static INLINE void stream(real *ptr, int offset, real2 v) { vstream_v_p_vq(&ptr[2*offset], v); }
+static INLINE void scatter(real *ptr, int offset, int step, real2 v) { vscatter2_v_p_i_i_vq(ptr, offset, step, v); }
+static INLINE void scstream(real *ptr, int offset, int step, real2 v) { vsscatter2_v_p_i_i_vq(ptr, offset, step, v); }
+
 static INLINE void prefetch(real *ptr, int offset) { vprefetch_v_p(&ptr[2*offset]); }
 #else
 #error No BASETYPEID specified
 #endif
 
+#if BASETYPEID == 1 || BASETYPEID == 2
+#include "dftconv.h"
+
+// Loads and stores that convert from and to the integer formats, for
+// the first and the last stages. The values are multiplied by scale.
+
+static INLINE real2 loadint16(const int16_t *ptr, int offset, real scale) {
+  real a[VECWIDTH*2];
+  for(int i=0;i<VECWIDTH*2;i++) a[i] = ptr[2*offset+i] * scale;
+  return loadu(a, 0);
+}
+
+static INLINE void storeint16(int16_t *ptr, int offset, real2 v, real scale) {
+  real a[VECWIDTH*2];
+  storeu(a, 0, times(v, loadc(scale)));
+  for(int i=0;i<VECWIDTH*2;i++) ptr[2*offset+i] = toInt16(a[i]);
+}
+
+static INLINE real2 loadint32(const int32_t *ptr, int offset, real scale) {
+  real a[VECWIDTH*2];
+  for(int i=0;i<VECWIDTH*2;i++) a[i] = ptr[2*offset+i] * scale;
+  return loadu(a, 0);
+}
+
+static INLINE void storeint32(int32_t *ptr, int offset, real2 v, real scale) {
+  real a[VECWIDTH*2];
+  storeu(a, 0, times(v, loadc(scale)));
+  for(int i=0;i<VECWIDTH*2;i++) ptr[2*offset+i] = toInt32(a[i]);
+}
+
+// Stores for the post-processing of the spectrum by the last stage.
+// Each of them stores VECWIDTH real values computed from the bins in
+// v at &ptr[offset]. The vector functions in libsleef are used where
+// they are available for the ISA.
+
+#if BASETYPEID == 1
+#define HYPOTX Sleef_hypot_u35
+#define LOG10X Sleef_log10_u10
+#define ATAN2X Sleef_atan2_u35
+#if defined(ENABLE_AVX512F)
+#define VHYPOT Sleef_hypotd8_u35avx512f
+#define VLOG10 Sleef_log10d8_u10avx512f
+#define VATAN2 Sleef_atan2d8_u35avx512f
+#elif defined(ENABLE_AVX2)
+#define VHYPOT Sleef_hypotd4_u35avx2
+#define VLOG10 Sleef_log10d4_u10avx2
+#define VATAN2 Sleef_atan2d4_u35avx2
+#elif defined(ENABLE_AVX)
+#define VHYPOT Sleef_hypotd4_u35avx
+#define VLOG10 Sleef_log10d4_u10avx
+#define VATAN2 Sleef_atan2d4_u35avx
+#elif defined(ENABLE_SSE2)
+#define VHYPOT Sleef_hypotd2_u35sse2
+#define VLOG10 Sleef_log10d2_u10sse2
+#define VATAN2 Sleef_atan2d2_u35sse2
+#endif
+#else // #if BASETYPEID == 1
+#define HYPOTX Sleef_hypotf_u35
+#define LOG10X Sleef_log10f_u10
+#define ATAN2X Sleef_atan2f_u35
+#if defined(ENABLE_AVX512F)
+#define VHYPOT Sleef_hypotf16_u35avx512f
+#define VLOG10 Sleef_log10f16_u10avx512f
+#define VATAN2 Sleef_atan2f16_u35avx512f
+#elif defined(ENABLE_AVX2)
+#define VHYPOT Sleef_hypotf8_u35avx2
+#define VLOG10 Sleef_log10f8_u10avx2
+#define VATAN2 Sleef_atan2f8_u35avx2
+#elif defined(ENABLE_AVX)
+#define VHYPOT Sleef_hypotf8_u35avx
+#define VLOG10 Sleef_log10f8_u10avx
+#define VATAN2 Sleef_atan2f8_u35avx
+#elif defined(ENABLE_SSE2)
+#define VHYPOT Sleef_hypotf4_u35sse2
+#define VLOG10 Sleef_log10f4_u10sse2
+#define VATAN2 Sleef_atan2f4_u35sse2
+#endif
+#endif // #if BASETYPEID == 1
+
+static INLINE real powervalue(real re, real im) { return re * re + im * im; }
+static INLINE real magnitudevalue(real re, real im) { return HYPOTX(re, im); }
+static INLINE real powerdbvalue(real re, real im) { return 10 * LOG10X(re * re + im * im); }
+static INLINE real phasevalue(real re, real im) { return ATAN2X(im, re); }
+
+// The results are in the even elements of the vectors
+static INLINE real2 vpower(real2 v) {
+  v = times(v, v);
+  return plus(v, reverse(v));
+}
+
+static INLINE void storeeven(real *ptr, int offset, real2 v) {
+  real a[VECWIDTH*2];
+  storeu(a, 0, v);
+  for(int i=0;i<VECWIDTH;i++) ptr[offset+i] = a[i*2];
+}
+
+static INLINE void storepower(real *ptr, int offset, real2 v) {
+  storeeven(ptr, offset, vpower(v));
+}
+
+static INLINE void storemagnitude(real *ptr, int offset, real2 v) {
+#ifdef VHYPOT
+  storeeven(ptr, offset, VHYPOT(v, reverse(v)));
+#else
+  real a[VECWIDTH*2];
+  storeu(a, 0, v);
+  for(int i=0;i<VECWIDTH;i++) ptr[offset+i] = magnitudevalue(a[i*2+0], a[i*2+1]);
+#endif
+}
+
+static INLINE void storepowerdb(real *ptr, int offset, real2 v) {
+#ifdef VLOG10
+  storeeven(ptr, offset, times(VLOG10(vpower(v)), loadc(10)));
+#else
+  real a[VECWIDTH*2];
+  storeu(a, 0, v);
+  for(int i=0;i<VECWIDTH;i++) ptr[offset+i] = powerdbvalue(a[i*2+0], a[i*2+1]);
+#endif
+}
+
+static INLINE void storephase(real *ptr, int offset, real2 v) {
+#ifdef VATAN2
+  storeeven(ptr, offset, VATAN2(reverse(v), v));
+#else
+  real a[VECWIDTH*2];
+  storeu(a, 0, v);
+  for(int i=0;i<VECWIDTH;i++) ptr[offset+i] = phasevalue(a[i*2+0], a[i*2+1]);
+#endif
+}
+#endif // #if BASETYPEID == 1 || BASETYPEID == 2
+
+#if BASETYPEID == 2
+
+// Loads and stores that convert from and to the 16-bit floating point
+// formats, for the first and the last stages. The offsets are in
+// complex numbers as in load(), and the pointers need not be aligned.
+
+static INLINE real2 loadfp16(const uint16_t *ptr, int offset) {
+#if defined(ENABLE_AVX512F)
+  return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)&ptr[2*offset]));
+#elif (defined(ENABLE_AVX) || defined(ENABLE_AVX2)) && defined(__F16C__)
+  return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)&ptr[2*offset]));
+#else
+  real a[VECWIDTH*2];
+  for(int i=0;i<VECWIDTH*2;i++) a[i] = fromFP16(ptr[2*offset+i]);
+  return loadu(a, 0);
+#endif
+}
+
+static INLINE void storefp16(uint16_t *ptr, int offset, real2 v) {
+#if defined(ENABLE_AVX512F)
+  _mm256_storeu_si256((__m256i *)&ptr[2*offset], _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#elif (defined(ENABLE_AVX) || defined(ENABLE_AVX2)) && defined(__F16C__)
+  _mm_storeu_si128((__m128i *)&ptr[2*offset], _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#else
+  real a[VECWIDTH*2];
+  storeu(a, 0, v);
+  for(int i=0;i<VECWIDTH*2;i++) ptr[2*offset+i] = toFP16(a[i]);
+#endif
+}
+
+static INLINE real2 loadbf16(const uint16_t *ptr, int offset) {
+  real a[VECWIDTH*2];
+  for(int i=0;i<VECWIDTH*2;i++) a[i] = fromBF16(ptr[2*offset+i]);
+  return loadu(a, 0);
+}
+
+static INLINE void storebf16(uint16_t *ptr, int offset, real2 v) {
+  real a[VECWIDTH*2];
+  storeu(a, 0, v);
+  for(int i=0;i<VECWIDTH*2;i++) ptr[2*offset+i] = toBF16(a[i]);
+}
+#endif // #if BASETYPEID == 2
+
 #endif